@@ -3,14 +3,52 @@
 #include <stdbool.h>   // Para usar o tipo booleano em C (true, false)
 #include <string.h>    // Para manipulação de strings (strtok, etc)
 #include <locale.h>    // Para configurar a linguagem/região (ex: pt_BR.UTF-8)
+#include <limits.h>    // Para INT_MAX (checagem de estouro no tamanho da fórmula)
+#include <stdint.h>    // Inteiros de tamanho fixo (formato binário de CNF)
+#include <fcntl.h>     // open (leitura do CNF binário)
+#include <unistd.h>    // close, getpid
+#include <sys/mman.h>  // mmap: o CNF binário é mapeado direto na memória
+#include <sys/stat.h>  // fstat (tamanho do arquivo)
+#include <pthread.h>   // Threads: componentes conexas resolvidas em paralelo
+#include <time.h>      // clock_gettime (prazo dos trabalhos no modo servidor)
+#include <errno.h>     // errno (socket do modo servidor)
+#include <sys/socket.h> // Socket Unix do modo servidor
+#include <sys/un.h>    // sockaddr_un
+#include <dirent.h>    // opendir (modo em lote com diretório)
+#include <signal.h>    // kill (prazo dos processos da bateria de desempenho)
+#include <sys/wait.h>  // wait4
+#include <sys/resource.h> // struct rusage: pico de memória de cada processo da bateria
+#include <stdarg.h>    // va_list (linhas de resposta do modo servidor)
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // AVX2 na avaliação de interpretações em lote (só usado se o processador tiver)
+#endif
+
+// 28ª ALTERAÇÃO: de qual vértice e de qual cor vem cada variável de uma fórmula de coloração
+typedef struct {
+    int num_vertices;  // Vértices da coloração
+    int k;             // Cores
+    int *vertice;      // vertice[x]: vértice (0..num_vertices-1) da variável x (1..num_vertices*k)
+    int *cor;          // cor[x]: cor (1..k) da variável x
+    int *variavel;     // variavel[u*k + c-1]: variável do vértice u com a cor c
+    int *grau;         // Grau de cada vértice no grafo (desempate da escolha do vértice)
+} MapaVariaveis;
 
 // Estrutura que representa uma fórmula CNF (Conjunctive Normal Form)
 typedef struct {
     int **clausulas;       // Matriz de cláusulas. Cada cláusula é um array de inteiros terminando com 0
     int num_clausulas;     // Quantidade total de cláusulas da fórmula
     int num_literais;      // Quantidade de variáveis (x1, x2, ..., xn)
+    int *arena;            // 6ª ALTERAÇÃO: bloco único com todos os literais (NULL se cada cláusula tem seu próprio malloc)
+    void *mapa;            // 7ª ALTERAÇÃO: arquivo .bcnf mapeado, quando as cláusulas apontam para dentro dele
+    size_t tam_mapa;       // Tamanho do mapeamento (0 se não há)
+    MapaVariaveis *vertices; // 28ª ALTERAÇÃO: variáveis → (vértice, cor) nas fórmulas de coloração (NULL nas demais)
 } Formula;
 
+// 6ª ALTERAÇÃO: exportar o sat.cnf vira apenas saída de depuração (compile com -DEXPORTAR_CNF=1 para ligar)
+#ifndef EXPORTAR_CNF
+#define EXPORTAR_CNF 0
+#endif
+
 // Estrutura para representar uma árvore binária de decisão
 typedef struct BinaryTree {
     int valor;               // Valor atribuído à variável neste ponto da árvore: 1 (true), -1 (false)
@@ -19,11 +57,426 @@ typedef struct BinaryTree {
     struct BinaryTree *direita;   // Ramo da árvore onde essa variável foi testada como falsa
 } BinaryTree;
 
-#define MAX_ARESTAS 2500 // 1ª ALTERAÇÃO: struct Grafo
+// 18ª ALTERAÇÃO: o que fez a busca parar antes de terminar
+typedef enum { LIMITE_NENHUM, LIMITE_TEMPO, LIMITE_CONFLITOS, LIMITE_MEMORIA, LIMITE_SINAL } MotivoLimite;
+
+// 14ª ALTERAÇÃO: prazo do trabalho em andamento (modo servidor); 18ª: conflitos, memória e sinais
+typedef struct {
+    double prazo;            // Instante limite em segundos (relógio monotônico); 0 = sem prazo
+    long long max_conflitos; // 18ª ALTERAÇÃO: conflitos permitidos; 0 = sem limite
+    long long max_memoria_kb; // 18ª ALTERAÇÃO: memória residente máxima; 0 = sem limite
+    long long conflitos;     // Conflitos já gastos pelas threads do trabalho (atômico)
+    int esgotado;            // Vira 1 quando um limite passa (atômico: várias threads do mesmo trabalho)
+    int motivo;              // MotivoLimite que esgotou
+    int limite_inferior;     // 18ª ALTERAÇÃO: K provado necessário até agora (atômico)
+} ControleTrabalho;
+
+static _Thread_local ControleTrabalho *controle_atual = NULL;  // NULL fora do modo servidor
+
+// Marca o trabalho como esgotado (o primeiro motivo é o que fica)
+// @return true se foi este motivo que esgotou o trabalho
+static bool esgotarControle(ControleTrabalho *c, MotivoLimite motivo)
+{
+    int esperado = 0;
+    if (__atomic_compare_exchange_n(&c->esgotado, &esperado, 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&c->motivo, (int)motivo, __ATOMIC_RELAXED);
+        return true;
+    }
+    return false;
+}
+
+// 16ª ALTERAÇÃO: contadores da busca do SAT (cada thread conta nos seus e descarrega no total)
+typedef struct {
+    long long decisoes;      // Variáveis escolhidas para ramificar
+    long long propagacoes;   // 17ª ALTERAÇÃO: atribuições forçadas (no DPLL fica 0; 25ª: o CDCL propaga)
+    long long conflitos;     // Ramos em que alguma cláusula ficou falsa
+    long long retrocessos;   // 17ª ALTERAÇÃO: vezes em que o ramo verdadeiro falhou e o falso foi tentado
+    long long reinicios;     // 17ª ALTERAÇÃO: recomeços da busca (no DPLL fica 0; 25ª: reinícios do CDCL)
+    long long aprendidas;    // 25ª ALTERAÇÃO: cláusulas aprendidas pelo CDCL
+    long long literais_antes;   // Soma dos tamanhos das aprendidas antes da minimização
+    long long literais_depois;  // e depois dela
+    long long fortalecidas;  // Razões que perderam um literal durante a análise
+    long long rodadas_inprocessamento;  // 26ª ALTERAÇÃO: rodadas de simplificação dentro do CDCL
+    long long satisfeitas_removidas;    // Cláusulas satisfeitas no nível 0 retiradas
+    long long subsumidas;               // Aprendidas apagadas por outra aprendida contida nelas
+    long long vivificadas;              // Cláusulas encurtadas pela vivificação
+    long long literais_removidos;       // Literais tirados pela vivificação e pela limpeza do nível 0
+} EstatisticasSAT;
+
+static _Thread_local EstatisticasSAT estatisticas_thread;
+EstatisticasSAT estatisticas_total;  // Somado com operações atômicas por descarregarEstatisticas
+
+// Soma os contadores desta thread no total e zera os dela
+static void descarregarEstatisticas(void)
+{
+    EstatisticasSAT *e = &estatisticas_thread;
+    __atomic_fetch_add(&estatisticas_total.decisoes, e->decisoes, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.propagacoes, e->propagacoes, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.conflitos, e->conflitos, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.retrocessos, e->retrocessos, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.reinicios, e->reinicios, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.aprendidas, e->aprendidas, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.literais_antes, e->literais_antes, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.literais_depois, e->literais_depois, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.fortalecidas, e->fortalecidas, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.rodadas_inprocessamento, e->rodadas_inprocessamento, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.satisfeitas_removidas, e->satisfeitas_removidas, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.subsumidas, e->subsumidas, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.vivificadas, e->vivificadas, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&estatisticas_total.literais_removidos, e->literais_removidos, __ATOMIC_RELAXED);
+    memset(e, 0, sizeof(*e));
+}
+
+// Segundos de um relógio monotônico (só diferenças fazem sentido)
+static double segundosAgora(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+// 17ª ALTERAÇÃO: tempo de cada etapa (somado entre as threads, em nanossegundos)
+typedef enum { FASE_LER_GRAFO, FASE_GERAR_CNF, FASE_LER_FORMULA, FASE_SAT, FASE_CSP, NUM_FASES } Fase;  // 24ª ALTERAÇÃO: FASE_CSP
+
+static const char *const nome_fase[NUM_FASES] = { "lerGrafo", "gerarCNF", "ler_formula", "SAT", "csp" };
+static long long nanos_fase[NUM_FASES];
+static long long chamadas_fase[NUM_FASES];
+static int fase_atual = -1;  // Última etapa iniciada (para as linhas de progresso)
+
+// Marca o começo de uma etapa e devolve o instante, para registrarFase
+static double iniciarFase(Fase fase)
+{
+    __atomic_store_n(&fase_atual, (int)fase, __ATOMIC_RELAXED);
+    return segundosAgora();
+}
+
+// Guarda em *pico o maior valor visto (atômico)
+static void registrarPico(long long *pico, long long valor)
+{
+    long long atual = __atomic_load_n(pico, __ATOMIC_RELAXED);
+    while (atual < valor && !__atomic_compare_exchange_n(pico, &atual, valor, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static long long pico_rss_fase[NUM_FASES];  // 19ª ALTERAÇÃO: pico de memória do processo ao fim de cada etapa (KB)
+
+static void registrarFase(Fase fase, double inicio)
+{
+    __atomic_fetch_add(&nanos_fase[fase], (long long)((segundosAgora() - inicio) * 1e9), __ATOMIC_RELAXED);
+    __atomic_fetch_add(&chamadas_fase[fase], 1, __ATOMIC_RELAXED);
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) == 0) registrarPico(&pico_rss_fase[fase], uso.ru_maxrss);
+}
+
+// 19ª ALTERAÇÃO: memória das estruturas do solver
+//
+// Cláusulas, vetores de interpretação e nós da árvore de decisão (o "rastro" do DPLL) passam
+// por alocarRastreado, que conta os bytes por categoria e o pico de cada etapa e recusa o que
+// passar do teto GCP_MAX_MEMORIA_MB. O DPLL não guarda cláusulas aprendidas que pudessem ser
+// descartadas, então o teto encerra a busca como um limite de memória esgotado: o relatório
+// da 18ª ALTERAÇÃO mostra o que já foi feito.
+
+// 25ª ALTERAÇÃO: MEM_VIGIAS (listas de vigias do CDCL)
+typedef enum { MEM_CLAUSULAS, MEM_INTERPRETACAO, MEM_ARVORE, MEM_VIGIAS, NUM_CATEGORIAS_MEM } CategoriaMemoria;
+
+static const char *const nome_categoria_mem[NUM_CATEGORIAS_MEM] = { "clausulas", "interpretacao", "arvore_decisao", "vigias" };
+static long long bytes_categoria[NUM_CATEGORIAS_MEM];  // Em uso agora (atômico)
+static long long pico_categoria[NUM_CATEGORIAS_MEM];
+static long long bytes_rastreados;                    // Soma das categorias (atômico)
+static long long pico_rastreado;
+static long long pico_rastreado_fase[NUM_FASES];
+static long long teto_memoria = 0;                    // Em bytes; 0 = sem teto
+static int teto_estourado = 0;                        // Algum pedido já foi recusado (atômico; só para as estatísticas)
+
+// Cabeçalho escondido antes de cada bloco: o tamanho e a categoria, para liberar sem informar
+typedef struct {
+    size_t tamanho;
+    size_t categoria;
+} CabecalhoMemoria;
+
+// Conta 'bytes' na categoria; false se passar do teto. A recusa esgota o trabalho atual (com
+// relatório, uma vez por trabalho): é o controle, e não um estado do processo, que diz a quem
+// chamou que um "não" do SAT não é prova.
+static bool reservarMemoria(CategoriaMemoria cat, size_t bytes)
+{
+    long long total = __atomic_add_fetch(&bytes_rastreados, (long long)bytes, __ATOMIC_RELAXED);
+    if (teto_memoria > 0 && total > teto_memoria) {
+        __atomic_sub_fetch(&bytes_rastreados, (long long)bytes, __ATOMIC_RELAXED);
+        __atomic_store_n(&teto_estourado, 1, __ATOMIC_RELAXED);
+        if (!controle_atual || esgotarControle(controle_atual, LIMITE_MEMORIA)) {
+            fprintf(stderr, "Teto de memória: pedido de %.1f MB para %s recusado com %.1f MB em uso (teto %.1f MB).\n",
+                    (double)bytes / 1048576.0, nome_categoria_mem[cat],
+                    (double)(total - (long long)bytes) / 1048576.0, (double)teto_memoria / 1048576.0);
+        }
+        return false;
+    }
+    long long na_categoria = __atomic_add_fetch(&bytes_categoria[cat], (long long)bytes, __ATOMIC_RELAXED);
+    registrarPico(&pico_categoria[cat], na_categoria);
+    registrarPico(&pico_rastreado, total);
+    int fase = __atomic_load_n(&fase_atual, __ATOMIC_RELAXED);
+    if (fase >= 0) registrarPico(&pico_rastreado_fase[fase], total);
+    return true;
+}
+
+static void devolverMemoria(CategoriaMemoria cat, size_t bytes)
+{
+    __atomic_sub_fetch(&bytes_categoria[cat], (long long)bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&bytes_rastreados, (long long)bytes, __ATOMIC_RELAXED);
+}
+
+/**
+ * malloc contado na categoria (liberar com liberarRastreado)
+ * @return NULL se faltou memória ou se passaria do teto
+ */
+void *alocarRastreado(CategoriaMemoria cat, size_t bytes)
+{
+    if (!reservarMemoria(cat, bytes)) return NULL;
+    CabecalhoMemoria *h = malloc(sizeof(CabecalhoMemoria) + bytes);
+    if (!h) {
+        devolverMemoria(cat, bytes);
+        return NULL;
+    }
+    h->tamanho = bytes;
+    h->categoria = cat;
+    return h + 1;
+}
+
+// Como alocarRastreado, mas com o bloco zerado (equivalente ao calloc)
+void *alocarRastreadoZerado(CategoriaMemoria cat, size_t bytes)
+{
+    void *p = alocarRastreado(cat, bytes);
+    if (p) memset(p, 0, bytes);
+    return p;
+}
+
+void liberarRastreado(void *p)
+{
+    if (!p) return;
+    CabecalhoMemoria *h = (CabecalhoMemoria*)p - 1;
+    devolverMemoria((CategoriaMemoria)h->categoria, h->tamanho);
+    free(h);
+}
+
+// realloc de um bloco rastreado (a categoria continua a mesma); NULL mantém o bloco antigo
+void *realocarRastreado(void *p, size_t bytes)
+{
+    if (!p) return NULL;
+    CabecalhoMemoria *h = (CabecalhoMemoria*)p - 1;
+    CategoriaMemoria cat = (CategoriaMemoria)h->categoria;
+    size_t antes = h->tamanho;
+    if (bytes > antes && !reservarMemoria(cat, bytes - antes)) return NULL;
+    CabecalhoMemoria *novo = realloc(h, sizeof(CabecalhoMemoria) + bytes);
+    if (!novo) {
+        if (bytes > antes) devolverMemoria(cat, bytes - antes);
+        return NULL;
+    }
+    if (bytes < antes) devolverMemoria(cat, antes - bytes);
+    novo->tamanho = bytes;
+    return novo + 1;
+}
+
+// 20ª ALTERAÇÃO: rastro binário da busca
+//
+// Compile com -DRASTREAR_BUSCA=1 e rode com GCP_RASTRO=arquivo. Cada evento do SAT vira um
+// registro de 16 bytes no anel da própria thread, sem trava (só a dona escreve, só a thread de
+// gravação lê); a gravação esvazia os anéis a cada 20 ms e, se um anel enche, os eventos são
+// descartados e contados. Sem a macro, RASTRO() não gera código nenhum no laço do SAT.
+// O GCP_Rastro.c converte o arquivo em linha do tempo ou resumo no formato de flame graph.
+#ifndef RASTREAR_BUSCA
+#define RASTREAR_BUSCA 0
+#endif
+
+enum {
+    RASTRO_INICIO_SAT = 1,  // valor: variáveis da fórmula
+    RASTRO_FIM_SAT,         // valor: 1 SAT, 0 UNSAT, -1 interrompido
+    RASTRO_DECISAO,         // valor: variável
+    RASTRO_CONFLITO,
+    RASTRO_RETROCESSO,      // valor: variável que passa a ser tentada como falsa
+    RASTRO_REINICIO,        // valor: rodada (25ª ALTERAÇÃO: só o CDCL reinicia)
+    RASTRO_PERDIDOS         // valor: eventos descartados com o anel cheio
+};
+
+#if RASTREAR_BUSCA
+// Registro do arquivo (o GCP_Rastro.c tem a mesma definição)
+typedef struct {
+    uint64_t tempo_ns;      // Desde o início do rastro
+    int32_t valor;
+    uint16_t profundidade;  // Decisões em aberto na thread (satura em 65535)
+    uint8_t tipo;
+    uint8_t thread;
+} RegistroRastro;
+
+#define TAM_ANEL_RASTRO (1u << 16)  // Registros por thread (1 MB)
+
+typedef struct AnelRastro {
+    RegistroRastro registros[TAM_ANEL_RASTRO];
+    uint64_t escrita;       // Próximo registro a escrever (só a thread dona avança)
+    uint64_t leitura;       // Próximo registro a gravar (só a thread de gravação avança)
+    uint64_t perdidos;      // Eventos descartados desde a última gravação (atômico)
+    int em_uso;             // 0 quando a thread dona terminou: o anel pode ser reaproveitado
+    uint8_t thread;
+    struct AnelRastro *proximo;
+} AnelRastro;
+
+static bool rastro_ligado = false;
+static FILE *arquivo_rastro = NULL;
+static uint64_t inicio_rastro_ns;
+static AnelRastro *aneis_rastro = NULL;  // Só cresce pela cabeça: a gravação percorre sem trava
+static pthread_mutex_t trava_aneis = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t chave_anel;
+static pthread_t thread_gravacao;
+static int parar_gravacao = 0;
+static int proxima_thread_rastro = 0;
+static _Thread_local AnelRastro *anel_thread = NULL;
+static _Thread_local unsigned profundidade_rastro = 0;
+
+static uint64_t nanossegundosAgora(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+// Destrutor da chave: a thread terminou e o anel fica livre depois de esvaziado
+static void soltarAnel(void *p)
+{
+    __atomic_store_n(&((AnelRastro*)p)->em_uso, 0, __ATOMIC_RELEASE);
+}
+
+static AnelRastro *pegarAnel(void)
+{
+    pthread_mutex_lock(&trava_aneis);
+    AnelRastro *a;
+    for (a = aneis_rastro; a; a = a->proximo) {
+        if (!__atomic_load_n(&a->em_uso, __ATOMIC_ACQUIRE) &&
+            __atomic_load_n(&a->leitura, __ATOMIC_ACQUIRE) == __atomic_load_n(&a->escrita, __ATOMIC_ACQUIRE)) break;
+    }
+    if (!a && (a = calloc(1, sizeof(AnelRastro))) != NULL) {
+        a->proximo = aneis_rastro;
+        __atomic_store_n(&aneis_rastro, a, __ATOMIC_RELEASE);
+    }
+    if (a) {
+        a->em_uso = 1;
+        a->thread = (uint8_t)proxima_thread_rastro++;
+    }
+    pthread_mutex_unlock(&trava_aneis);
+    if (a) pthread_setspecific(chave_anel, a);
+    return a;
+}
+
+static void registrarEvento(uint8_t tipo, int32_t valor)
+{
+    AnelRastro *a = anel_thread;
+    if (!a && (a = anel_thread = pegarAnel()) == NULL) return;
+    uint64_t w = a->escrita;
+    if (w - __atomic_load_n(&a->leitura, __ATOMIC_ACQUIRE) >= TAM_ANEL_RASTRO) {
+        __atomic_fetch_add(&a->perdidos, 1, __ATOMIC_RELAXED);  // Cheio: a busca não espera o disco
+        return;
+    }
+    RegistroRastro *r = &a->registros[w & (TAM_ANEL_RASTRO - 1)];
+    r->tempo_ns = nanossegundosAgora() - inicio_rastro_ns;
+    r->valor = valor;
+    r->profundidade = profundidade_rastro > 65535 ? 65535 : (uint16_t)profundidade_rastro;
+    r->tipo = tipo;
+    r->thread = a->thread;
+    __atomic_store_n(&a->escrita, w + 1, __ATOMIC_RELEASE);
+}
+
+// Grava o que há em cada anel (chamada pela thread de gravação e no fim do programa)
+static void esvaziarAneis(void)
+{
+    for (AnelRastro *a = __atomic_load_n(&aneis_rastro, __ATOMIC_ACQUIRE); a; a = a->proximo) {
+        uint64_t r = a->leitura, w = __atomic_load_n(&a->escrita, __ATOMIC_ACQUIRE);
+        while (r < w) {
+            size_t ini = (size_t)(r & (TAM_ANEL_RASTRO - 1));
+            size_t n = (size_t)(w - r) < TAM_ANEL_RASTRO - ini ? (size_t)(w - r) : TAM_ANEL_RASTRO - ini;
+            fwrite(&a->registros[ini], sizeof(RegistroRastro), n, arquivo_rastro);
+            r += n;
+        }
+        __atomic_store_n(&a->leitura, r, __ATOMIC_RELEASE);
+
+        uint64_t perdidos = __atomic_exchange_n(&a->perdidos, 0, __ATOMIC_RELAXED);
+        if (perdidos) {
+            RegistroRastro aviso = { nanossegundosAgora() - inicio_rastro_ns,
+                                     perdidos > INT32_MAX ? INT32_MAX : (int32_t)perdidos, 0, RASTRO_PERDIDOS, a->thread };
+            fwrite(&aviso, sizeof(aviso), 1, arquivo_rastro);
+        }
+    }
+    fflush(arquivo_rastro);
+}
+
+static void *threadGravacao(void *arg)
+{
+    (void)arg;
+    struct timespec pausa = { 0, 20000000 };  // 20 ms
+    while (!__atomic_load_n(&parar_gravacao, __ATOMIC_RELAXED)) {
+        nanosleep(&pausa, NULL);
+        esvaziarAneis();
+    }
+    return NULL;
+}
+
+static void encerrarRastro(void)
+{
+    __atomic_store_n(&parar_gravacao, 1, __ATOMIC_RELAXED);
+    pthread_join(thread_gravacao, NULL);
+    esvaziarAneis();  // O que as threads escreveram depois da última passada
+    fclose(arquivo_rastro);
+}
+
+// Abre o arquivo de GCP_RASTRO e liga os eventos (chamada uma vez, no início do main)
+void iniciarRastro(void)
+{
+    const char *nome = getenv("GCP_RASTRO");
+    if (!nome || !*nome) return;
+    arquivo_rastro = fopen(nome, "wb");
+    if (!arquivo_rastro) {
+        perror(nome);
+        return;
+    }
+    // Cabeçalho: assinatura, versão e tamanho do registro (16)
+    uint32_t cabecalho[2] = { 1, (uint32_t)sizeof(RegistroRastro) };
+    fwrite("GCPRASTR", 1, 8, arquivo_rastro);
+    fwrite(cabecalho, sizeof(cabecalho), 1, arquivo_rastro);
+    pthread_key_create(&chave_anel, soltarAnel);
+    inicio_rastro_ns = nanossegundosAgora();
+    if (pthread_create(&thread_gravacao, NULL, threadGravacao, NULL) != 0) {
+        fclose(arquivo_rastro);
+        return;
+    }
+    rastro_ligado = true;
+    atexit(encerrarRastro);
+}
+
+#define RASTRO(tipo, valor) do { if (rastro_ligado) registrarEvento((tipo), (valor)); } while (0)
+#define RASTRO_DESCER() (profundidade_rastro++)
+#define RASTRO_SUBIR() (profundidade_rastro--)
+#define RASTRO_PROFUNDIDADE(d) (profundidade_rastro = (unsigned)(d))  // 25ª ALTERAÇÃO: o CDCL volta vários níveis de uma vez
+#else
+void iniciarRastro(void)
+{
+    if (getenv("GCP_RASTRO")) fprintf(stderr, "Aviso: GCP_RASTRO ignorado (compile com -DRASTREAR_BUSCA=1).\n");
+}
+
+#define RASTRO(tipo, valor) ((void)0)
+#define RASTRO_DESCER() ((void)0)
+#define RASTRO_SUBIR() ((void)0)
+#define RASTRO_PROFUNDIDADE(d) ((void)0)
+#endif
+
+// 8ª ALTERAÇÃO: MAX_ARESTAS deixa de ser o tamanho de um vetor fixo e vira só o teto da lista dinâmica
+#define MAX_ARESTAS ((size_t)INT_MAX) // 1ª ALTERAÇÃO: struct Grafo
 typedef struct {
     int n_vertices;                   // Número de vértices do grafo
     int m_arestas;                    // Número de arestas
-    int arestas[MAX_ARESTAS][2];     // Lista de arestas, onde cada aresta é um par (v1, v2)
+    size_t capacidade_arestas;        // 8ª ALTERAÇÃO: espaço alocado na lista de arestas
+    int (*arestas)[2];                // Lista de arestas (no heap), onde cada aresta é um par (v1, v2)
+    // 9ª ALTERAÇÃO: adjacência CSR, montada por construirAdjacencia ao ler o grafo
+    size_t *adj_inicio;               // Vizinhos de v ficam em adj_vizinhos[adj_inicio[v] .. adj_inicio[v+1]-1]
+    int *adj_vizinhos;                // Listas de vizinhos ordenadas, sem repetição e sem laços
+    int m_distintas;                  // Arestas distintas (sem repetidas, invertidas ou laços)
+    int num_lacos;                    // Quantos vértices têm laço (aresta v-v)
+    int *lacos;                       // Esses vértices, em ordem crescente
 } Grafo;
 
 /**
@@ -35,7 +488,7 @@ void liberar_arvore(BinaryTree *no)
     if (no == NULL) return;          // Se o nó é nulo, retorna
     liberar_arvore(no->esquerda);    // Libera a subárvore esquerda recursivamente
     liberar_arvore(no->direita);     // Libera a subárvore direita recursivamente
-    free(no);                        // Libera o nó atual
+    liberarRastreado(no);            // Libera o nó atual (19ª ALTERAÇÃO: memória contada)
 }
 
 /**
@@ -51,97 +504,267 @@ bool literal_valido(int literal, int num_literais)
     return (var >= 1 && var <= num_literais);
 }
 
-/**
- * Lê uma fórmula CNF de um arquivo no formato DIMACS
- * @param file Nome do arquivo a ser lido
- * @return Ponteiro para a fórmula lida ou NULL em caso de erro
- */
-// Função para ler uma fórmula CNF de um arquivo no formato DIMACS
-Formula* ler_formula(const char *file) 
-{
-    FILE *arquivo = fopen(file, "r");  // Abre o arquivo no modo leitura
-    if (!arquivo)                      // Se o ponteiro for NULL, deu erro
-    {
-        printf("Erro ao abrir o arquivo");  // Informa erro
-        return NULL;                        // Retorna NULL para sinalizar falha
-    }
+void liberar_formula(Formula *f);  // 19ª ALTERAÇÃO: usada nos erros de memória de ler_formula
+void liberarMapaVariaveis(MapaVariaveis *m);  // 28ª ALTERAÇÃO
 
-    Formula *f = malloc(sizeof(Formula));  // Aloca espaço para a estrutura Formula
-    f->clausulas = NULL;                   // Inicializa o ponteiro de cláusulas como vazio
-    f->num_clausulas = 0;                 // Ainda não lemos nenhuma cláusula
-    f->num_literais = 0;                  // Ainda não sabemos quantas variáveis existem
+// 14ª ALTERAÇÃO: leitura do DIMACS com verificação de tudo (o modo servidor lê arquivos de
+// qualquer cliente, e um arquivo malformado não pode derrubar o processo). Os literais vão
+// para uma arena só, como em construirFormula; as cláusulas podem ocupar várias linhas.
 
-    char linha[1000];         // Buffer para armazenar cada linha lida do arquivo
-    int clausula_atual = 0;   // Índice usado para inserir cláusulas no array
+#define TAM_BUFFER_DIMACS 65536
 
-    // Percorre linha a linha o conteúdo do arquivo
-    while (fgets(linha, sizeof(linha), arquivo)) 
-    {
-        if (linha[0] == 'c') continue;  // Ignora linhas de comentário (começam com 'c')
+typedef struct {
+    FILE *arquivo;
+    char buf[TAM_BUFFER_DIMACS];
+    size_t pos, tam;
+    int linha;        // Linha atual (para as mensagens de erro)
+} LeitorDIMACS;
 
-        if (linha[0] == 'p')            // Se for linha de cabeçalho ("p cnf ...")
-        {
-            // Lê o número de variáveis e de cláusulas da fórmula
-            sscanf(linha, "p cnf %d %d", &f->num_literais, &f->num_clausulas);
+static int lerByteDIMACS(LeitorDIMACS *l)
+{
+    if (l->pos == l->tam) {
+        l->tam = fread(l->buf, 1, sizeof(l->buf), l->arquivo);
+        l->pos = 0;
+        if (l->tam == 0) return EOF;
+    }
+    return (unsigned char)l->buf[l->pos++];
+}
 
-            // Aloca o vetor de ponteiros onde cada posição será uma cláusula
-            f->clausulas = malloc(f->num_clausulas * sizeof(int*));
-            continue; // Passa para a próxima linha
-        }
+static bool espacoDIMACS(int c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
 
-        // === Leitura de cláusulas ===
+// Pula até o fim da linha (comentários)
+static void pularLinhaDIMACS(LeitorDIMACS *l)
+{
+    int c;
+    while ((c = lerByteDIMACS(l)) != EOF && c != '\n') {
+    }
+    if (c == '\n') l->linha++;
+}
 
-        // Cria um vetor para a cláusula atual, com espaço para todos os literais + terminador (0)
-        int *clausula = malloc((f->num_literais + 1) * sizeof(int));
+/**
+ * Lê uma fórmula DIMACS conferindo o cabeçalho, o intervalo de cada literal e a quantidade de
+ * cláusulas anunciada
+ * @param file Nome do arquivo
+ * @param erro Saída: o motivo da falha (uma linha, sem quebra)
+ * @param tam_erro Tamanho de 'erro'
+ * @return Fórmula (em arena) ou NULL com o motivo em 'erro'
+ */
+Formula* lerFormulaDIMACS(const char *file, char *erro, size_t tam_erro)
+{
+    double inicio = iniciarFase(FASE_LER_FORMULA);  // 17ª ALTERAÇÃO: tempo da etapa
+    LeitorDIMACS *l = malloc(sizeof(LeitorDIMACS));
+    if (!l) {
+        snprintf(erro, tam_erro, "memória insuficiente");
+        return NULL;
+    }
+    l->arquivo = fopen(file, "r");
+    l->pos = l->tam = 0;
+    l->linha = 1;
+    if (!l->arquivo) {
+        snprintf(erro, tam_erro, "não foi possível abrir %s", file);
+        free(l);
+        return NULL;
+    }
 
-        int literal;         // Armazena temporariamente cada literal lido
-        int tamanho = 0;     // Contador de quantos literais já inserimos na cláusula
+    int num_vars = 0, declaradas = 0, lidas = 0;
+    bool tem_cabecalho = false, clausula_aberta = false, ok = true;
+    int *arena = NULL, *inicios = NULL;         // Literais (com os 0) e onde começa cada cláusula
+    size_t tam_arena = 0, cap_arena = 0, cap_inicios = 0;
+    int c;
 
-        // Divide a linha em tokens (números separados por espaço/tab/enter)
-        char *token = strtok(linha, " \t\n");
+    while (ok && (c = lerByteDIMACS(l)) != EOF) {
+        if (c == '\n') {
+            l->linha++;
+            continue;
+        }
+        if (espacoDIMACS(c)) continue;
+        if (c == 'c') {
+            pularLinhaDIMACS(l);
+            continue;
+        }
+        if (c == '%') break;  // Fim no estilo SATLIB ("%" e um "0" solto depois)
 
-        // Processa todos os literais da linha
-        while (token != NULL) 
-        {
-            literal = atoi(token);  // Converte string para inteiro
+        if (c == 'p') {
+            char cabecalho[256];
+            size_t n = 0;
+            cabecalho[n++] = 'p';
+            while ((c = lerByteDIMACS(l)) != EOF && c != '\n' && n + 1 < sizeof(cabecalho)) cabecalho[n++] = (char)c;
+            cabecalho[n] = '\0';
+            int fim = 0;
+            if (tem_cabecalho) {
+                snprintf(erro, tam_erro, "linha %d: cabeçalho repetido", l->linha);
+                ok = false;
+            } else if (c != '\n' && c != EOF) {
+                snprintf(erro, tam_erro, "linha %d: cabeçalho longo demais", l->linha);
+                ok = false;
+            } else if (sscanf(cabecalho, "p cnf %d %d %n", &num_vars, &declaradas, &fim) < 2 || cabecalho[fim] != '\0' ||
+                       num_vars < 0 || declaradas < 0) {
+                snprintf(erro, tam_erro, "linha %d: cabeçalho inválido (esperado \"p cnf <variáveis> <cláusulas>\")", l->linha);
+                ok = false;
+            }
+            tem_cabecalho = true;
+            if (c == '\n') l->linha++;
+            continue;
+        }
 
-            if (literal == 0) break;  // Fim da cláusula (DIMACS termina cláusulas com 0)
+        if (c != '-' && (c < '0' || c > '9')) {
+            if (c >= 32 && c < 127) snprintf(erro, tam_erro, "linha %d: caractere inesperado '%c'", l->linha, c);
+            else snprintf(erro, tam_erro, "linha %d: byte inesperado 0x%02x", l->linha, c);
+            ok = false;
+            break;
+        }
+        if (!tem_cabecalho) {
+            snprintf(erro, tam_erro, "linha %d: cláusula antes da linha \"p cnf\"", l->linha);
+            ok = false;
+            break;
+        }
 
-            // Verifica se o literal está dentro do intervalo permitido
-            if (!literal_valido(literal, f->num_literais))
-            {
-                // Se inválido, mostra erro e aborta
-                printf("Erro: literal %d invalido (max: %d)\n", literal, f->num_literais);
-                printf("UNSAT\n");  // Fórmula insatisfatível por erro
-                free(clausula);    // Libera memória da cláusula mal formada
-                fclose(arquivo);   // Fecha o arquivo
-                return NULL;       // Sinaliza erro
+        // Literal: sinal opcional, dígitos e um separador
+        bool negativo = c == '-';
+        long long valor = 0;
+        int digitos = 0;
+        if (negativo) c = lerByteDIMACS(l);
+        while (c >= '0' && c <= '9') {
+            valor = valor * 10 + (c - '0');
+            if (valor > INT_MAX) break;
+            digitos++;
+            c = lerByteDIMACS(l);
+        }
+        if (digitos == 0 || valor > INT_MAX || (c != EOF && !espacoDIMACS(c))) {
+            snprintf(erro, tam_erro, "linha %d: literal malformado", l->linha);
+            ok = false;
+            break;
+        }
+        int literal = negativo ? -(int)valor : (int)valor;
+        if (literal != 0 && !literal_valido(literal, num_vars)) {
+            snprintf(erro, tam_erro, "linha %d: literal %d fora do intervalo (máximo: %d)", l->linha, literal, num_vars);
+            ok = false;
+            break;
+        }
+        if (!clausula_aberta) {  // Começa uma cláusula
+            if (lidas == declaradas) {
+                snprintf(erro, tam_erro, "linha %d: mais cláusulas que as %d do cabeçalho", l->linha, declaradas);
+                ok = false;
+                break;
             }
-
-            clausula[tamanho++] = literal;      // Armazena literal na cláusula
-            token = strtok(NULL, " \t\n");      // Vai para o próximo número
+            if ((size_t)lidas == cap_inicios) {
+                size_t cap = cap_inicios ? 2 * cap_inicios : 1024;
+                int *novo = inicios ? realocarRastreado(inicios, cap * sizeof(int)) : alocarRastreado(MEM_CLAUSULAS, cap * sizeof(int));
+                if (!novo) {
+                    snprintf(erro, tam_erro, "memória insuficiente");
+                    ok = false;
+                    break;
+                }
+                inicios = novo;
+                cap_inicios = cap;
+            }
+            if (tam_arena > INT_MAX) {
+                snprintf(erro, tam_erro, "fórmula grande demais");
+                ok = false;
+                break;
+            }
+            inicios[lidas] = (int)tam_arena;
+            clausula_aberta = true;
+        }
+        if (tam_arena == cap_arena) {
+            size_t cap = cap_arena ? 2 * cap_arena : 4096;
+            int *nova = arena ? realocarRastreado(arena, cap * sizeof(int)) : alocarRastreado(MEM_CLAUSULAS, cap * sizeof(int));
+            if (!nova) {
+                snprintf(erro, tam_erro, "memória insuficiente");
+                ok = false;
+                break;
+            }
+            arena = nova;
+            cap_arena = cap;
+        }
+        arena[tam_arena++] = literal;
+        if (literal == 0) {
+            clausula_aberta = false;
+            lidas++;
         }
+        if (c == '\n') l->linha++;  // O separador do literal
+    }
+    fclose(l->arquivo);
+    free(l);
 
-        clausula[tamanho] = 0;                  // Adiciona terminador 0 no final da cláusula
+    if (ok && !tem_cabecalho) {
+        snprintf(erro, tam_erro, "falta a linha \"p cnf\"");
+        ok = false;
+    } else if (ok && clausula_aberta) {
+        snprintf(erro, tam_erro, "a última cláusula não termina com 0");
+        ok = false;
+    } else if (ok && lidas != declaradas) {
+        snprintf(erro, tam_erro, "o cabeçalho anuncia %d cláusulas, mas o arquivo tem %d", declaradas, lidas);
+        ok = false;
+    }
 
-        f->clausulas[clausula_atual++] = clausula;  // Guarda a cláusula no array de cláusulas da fórmula
+    Formula *f = ok ? malloc(sizeof(Formula)) : NULL;
+    int **clausulas = f ? alocarRastreado(MEM_CLAUSULAS, (size_t)(lidas > 0 ? lidas : 1) * sizeof(int*)) : NULL;
+    if (ok && (!f || !clausulas)) snprintf(erro, tam_erro, "memória insuficiente");
+    if (!clausulas) {
+        free(f);
+        liberarRastreado(arena);
+        liberarRastreado(inicios);
+        return NULL;
     }
+    if (!arena) arena = alocarRastreado(MEM_CLAUSULAS, sizeof(int));  // Sem cláusulas: a arena marca o dono
+    for (int i = 0; i < lidas; i++) clausulas[i] = arena + inicios[i];
+    liberarRastreado(inicios);
 
-    fclose(arquivo);  // Fecha o arquivo após leitura completa
+    f->clausulas = clausulas;
+    f->num_clausulas = lidas;
+    f->num_literais = num_vars;
+    f->arena = arena;
+    f->mapa = NULL;
+    f->tam_mapa = 0;
+    f->vertices = NULL;  // Fórmula qualquer: sem vértices por trás das variáveis
+    if (!f->arena) {
+        snprintf(erro, tam_erro, "memória insuficiente");
+        liberar_formula(f);
+        return NULL;
+    }
+    registrarFase(FASE_LER_FORMULA, inicio);
+    return f;
+}
 
-    return f;         // Retorna ponteiro para a fórmula construída
+/**
+ * Lê uma fórmula CNF de um arquivo no formato DIMACS
+ * @param file Nome do arquivo a ser lido
+ * @return Ponteiro para a fórmula lida ou NULL em caso de erro (o motivo vai para a saída)
+ */
+Formula* ler_formula(const char *file)
+{
+    char erro[256];
+    Formula *f = lerFormulaDIMACS(file, erro, sizeof(erro));  // 14ª ALTERAÇÃO: leitura verificada
+    if (!f) printf("Erro ao ler %s: %s\n", file, erro);
+    return f;
 }
 
 
 // Função para liberar a memória alocada para a fórmula
 void liberar_formula(Formula *f) 
 {
-    // Libera cada cláusula individualmente
-    for (int i = 0; i < f->num_clausulas; i++) 
+    if (f->mapa)  // Fórmula carregada de um .bcnf: as cláusulas moram no arquivo mapeado
+    {
+        munmap(f->mapa, f->tam_mapa);
+    }
+    else if (f->arena)  // Fórmula montada em memória: todas as cláusulas moram na arena
+    {
+        liberarRastreado(f->arena);
+    }
+    else if (f->clausulas)
     {
-        free(f->clausulas[i]);
+        // Libera cada cláusula individualmente
+        for (int i = 0; i < f->num_clausulas; i++) 
+        {
+            liberarRastreado(f->clausulas[i]);
+        }
     }
-    free(f->clausulas);  // Libera o vetor de cláusulas
+    liberarRastreado(f->clausulas);  // Libera o vetor de cláusulas
+    liberarMapaVariaveis(f->vertices);  // 28ª ALTERAÇÃO
     free(f);             // Libera a estrutura da fórmula
 }
 
@@ -242,6 +865,175 @@ int proxima_variavel_nao_atribuida(Formula *f, int *interpretacao)
     return 0;  // Todas as variáveis já foram atribuídas
 }
 
+// 28ª ALTERAÇÃO: escolha da decisão pelo grafo
+//
+// Nas fórmulas de coloração a variável (v-1)*k + c quer dizer "o vértice v tem a cor c", mas a
+// escolha acima (e o VSIDS do CDCL) tratam todas como iguais. O construtor da fórmula
+// (construirFormula, recolorirRegiao) agora exporta o MapaVariaveis, e com ele o solver decide
+// como o DSatur: o vértice sem cor com menos cores ainda possíveis (desempate pelo maior grau)
+// recebe a cor possível menos usada até agora. Quando todos os vértices têm cor, volta à
+// escolha genérica. GCP_RAMIFICACAO=generica ignora o mapa.
+
+/**
+ * Aloca o mapa das variáveis da coloração de n vértices com k cores, na numeração u*k + c
+ * (u a partir de 0) usada pelas fórmulas de coloração. Os graus começam em 0.
+ * @return Mapa ou NULL sem memória (o solver só perde a escolha pelo grafo)
+ */
+MapaVariaveis *criarMapaVariaveis(int n, int k)
+{
+    size_t num_vars = (size_t)n * (size_t)k;
+    MapaVariaveis *m = malloc(sizeof(MapaVariaveis));
+    if (!m) return NULL;
+    m->num_vertices = n;
+    m->k = k;
+    m->vertice = alocarRastreado(MEM_CLAUSULAS, (num_vars + 1) * sizeof(int));
+    m->cor = alocarRastreado(MEM_CLAUSULAS, (num_vars + 1) * sizeof(int));
+    m->variavel = alocarRastreado(MEM_CLAUSULAS, (num_vars + 1) * sizeof(int));
+    m->grau = alocarRastreadoZerado(MEM_CLAUSULAS, ((size_t)n + 1) * sizeof(int));
+    if (!m->vertice || !m->cor || !m->variavel || !m->grau) {
+        liberarMapaVariaveis(m);
+        return NULL;
+    }
+    m->vertice[0] = m->cor[0] = 0;
+    for (int u = 0; u < n; u++) {
+        for (int c = 1; c <= k; c++) {
+            int x = u * k + c;
+            m->vertice[x] = u;
+            m->cor[x] = c;
+            m->variavel[u * k + c - 1] = x;
+        }
+    }
+    return m;
+}
+
+void liberarMapaVariaveis(MapaVariaveis *m)
+{
+    if (!m) return;
+    liberarRastreado(m->vertice);
+    liberarRastreado(m->cor);
+    liberarRastreado(m->variavel);
+    liberarRastreado(m->grau);
+    free(m);
+}
+
+// A fórmula tem mapa e a escolha pelo grafo não foi desligada (GCP_RAMIFICACAO=generica)?
+// Consultada uma vez por fórmula (prepararCDCL, resolverFormula), não a cada decisão.
+bool ramificarPeloGrafo(const Formula *f)
+{
+    const char *env = getenv("GCP_RAMIFICACAO");
+    return f->vertices && f->vertices->num_vertices * f->vertices->k == f->num_literais &&
+           !(env && strcmp(env, "generica") == 0);
+}
+
+// Vetor de trabalho (k+1 cores) da escolha pelo grafo no SAT(); resolverFormula o aloca uma
+// vez por fórmula. NULL: o SAT() usa a escolha genérica.
+static _Thread_local int *uso_cor_dpll = NULL;
+
+/**
+ * Escolha do SAT() pelo grafo: a variável da cor possível menos usada do vértice sem cor com
+ * menos cores possíveis. Recalcula tudo a partir da interpretação (o SAT() já percorre a
+ * fórmula inteira a cada nó), no vetor uso_cor_dpll.
+ * @return Variável ou 0 se todos os vértices já têm cor
+ */
+int proximaVariavelGrafo(Formula *f, int *interpretacao)
+{
+    const MapaVariaveis *m = f->vertices;
+    int k = m->k;
+    int *uso_cor = uso_cor_dpll;
+    for (int c = 1; c <= k; c++) uso_cor[c] = 0;
+    for (int x = 1; x <= f->num_literais; x++) {
+        if (interpretacao[x] == 1) uso_cor[m->cor[x]]++;
+    }
+
+    int melhor = -1, menor_livres = INT_MAX;
+    for (int u = 0; u < m->num_vertices; u++) {
+        const int *vars = m->variavel + (size_t)u * k;
+        int livres = 0;
+        bool colorido = false;
+        for (int c = 0; c < k && !colorido; c++) {
+            if (interpretacao[vars[c]] == 1) colorido = true;
+            else if (interpretacao[vars[c]] == 0) livres++;
+        }
+        if (colorido || livres == 0) continue;
+        if (livres < menor_livres || (livres == menor_livres && m->grau[u] > m->grau[melhor])) {
+            melhor = u;
+            menor_livres = livres;
+        }
+    }
+    int escolhida = 0;
+    for (int c = 1; melhor >= 0 && c <= k; c++) {
+        int x = m->variavel[(size_t)melhor * k + c - 1];
+        if (interpretacao[x] == 0 && (escolhida == 0 || uso_cor[c] < uso_cor[m->cor[escolhida]])) escolhida = x;
+    }
+    return escolhida;
+}
+
+static _Thread_local long long conflitos_nao_contados;  // Conflitos ainda não somados no controle
+
+// Memória residente do processo em KB (0 se /proc não estiver disponível)
+static long long memoriaResidenteKB(void)
+{
+    long long paginas_total, paginas_residentes;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    int lidos = fscanf(statm, "%lld %lld", &paginas_total, &paginas_residentes);
+    fclose(statm);
+    return lidos == 2 ? paginas_residentes * (sysconf(_SC_PAGESIZE) / 1024) : 0;
+}
+
+/**
+ * Verifica se algum limite do trabalho atual acabou (14ª ALTERAÇÃO; 18ª: conflitos e memória).
+ * Os limites só são consultados a cada 64 chamadas (a memória, a cada 1024) para não pesar na busca.
+ * @return true se o SAT deve desistir
+ */
+static bool limiteEsgotado(void)
+{
+    static _Thread_local unsigned chamadas = 0;
+    ControleTrabalho *c = controle_atual;
+    if (!c) return false;
+    if (__atomic_load_n(&c->esgotado, __ATOMIC_RELAXED)) return true;
+    if ((++chamadas & 63) != 0) return false;
+
+    long long gastos = __atomic_add_fetch(&c->conflitos, conflitos_nao_contados, __ATOMIC_RELAXED);
+    conflitos_nao_contados = 0;
+    if (c->max_conflitos > 0 && gastos >= c->max_conflitos) esgotarControle(c, LIMITE_CONFLITOS);
+    else if (c->prazo > 0 && segundosAgora() >= c->prazo) esgotarControle(c, LIMITE_TEMPO);
+    else if (c->max_memoria_kb > 0 && (chamadas & 1023) == 0 && memoriaResidenteKB() > c->max_memoria_kb) {
+        esgotarControle(c, LIMITE_MEMORIA);
+    }
+    return __atomic_load_n(&c->esgotado, __ATOMIC_RELAXED);
+}
+
+/**
+ * Preenche os limites de um trabalho (18ª ALTERAÇÃO). O que não vier por parâmetro vem
+ * do ambiente: GCP_PRAZO (segundos), GCP_MAX_CONFLITOS e GCP_MAX_MEMORIA_MB.
+ * @param c Controle a preencher
+ * @param prazo Segundos a partir de agora (0 = usar GCP_PRAZO)
+ */
+void configurarControle(ControleTrabalho *c, double prazo)
+{
+    memset(c, 0, sizeof(*c));
+    const char *env = getenv("GCP_PRAZO");
+    if (prazo <= 0 && env) prazo = atof(env);
+    if (prazo > 0) c->prazo = segundosAgora() + prazo;
+    env = getenv("GCP_MAX_CONFLITOS");
+    if (env) c->max_conflitos = atoll(env);
+    env = getenv("GCP_MAX_MEMORIA_MB");
+    if (env) c->max_memoria_kb = atoll(env) * 1024;
+}
+
+// Nome do motivo de parada nas saídas de texto (CSV, JSONL e servidor)
+const char *nomeLimite(int motivo)
+{
+    switch (motivo) {
+        case LIMITE_TEMPO:     return "tempo_esgotado";
+        case LIMITE_CONFLITOS: return "limite_conflitos";
+        case LIMITE_MEMORIA:   return "limite_memoria";
+        case LIMITE_SINAL:     return "interrompido";
+        default:               return "erro";
+    }
+}
+
 // Função que implementa um solver SAT (problema de satisfabilidade booleana) usando backtracking
 // e construindo uma árvore binária de decisão durante o processo.
 //
@@ -255,19 +1047,31 @@ int proxima_variavel_nao_atribuida(Formula *f, int *interpretacao)
 //   - false caso contrário
 bool SAT(Formula *f, int *interpretacao, BinaryTree *no) 
 {
+    // 14ª ALTERAÇÃO: trabalho com limite esgotado desiste (quem chamou distingue pelo controle)
+    if (limiteEsgotado()) return false;
+
     // Casos base:
     
     // Verifica se a fórmula já está satisfeita com a interpretação atual
     if (formula_satisfativel(f, interpretacao)) return true;
     
     // Verifica se a fórmula é insatisfatível com a interpretação atual
-    if (formula_insatisfativel(f, interpretacao)) return false;
+    if (formula_insatisfativel(f, interpretacao)) {
+        estatisticas_thread.conflitos++;
+        conflitos_nao_contados++;
+        RASTRO(RASTRO_CONFLITO, 0);
+        return false;
+    }
 
     // Passo recursivo:
     
     // Escolhe a próxima variável não atribuída para tentar uma atribuição
-    int var = proxima_variavel_nao_atribuida(f, interpretacao);
+    // 28ª ALTERAÇÃO: nas fórmulas de coloração, o vértice e a cor pelo grafo
+    int var = uso_cor_dpll ? proximaVariavelGrafo(f, interpretacao) : 0;
+    if (var == 0) var = proxima_variavel_nao_atribuida(f, interpretacao);
     if (var == 0) return false;  // Não há mais variáveis não atribuídas
+    if (++estatisticas_thread.decisoes >= 4096) descarregarEstatisticas();  // Progresso visível no total
+    RASTRO(RASTRO_DECISAO, var);
 
     // Se é a raiz (nó vazio), inicializa o nó com a variável atual
     if (no->variavel == 0) 
@@ -276,27 +1080,36 @@ bool SAT(Formula *f, int *interpretacao, BinaryTree *no)
     }
 
     // Tenta atribuir verdadeiro (1) à variável atual
-    no->esquerda = malloc(sizeof(BinaryTree));
+    no->esquerda = alocarRastreado(MEM_ARVORE, sizeof(BinaryTree));
+    if (!no->esquerda) return false;  // 19ª ALTERAÇÃO: teto de memória (quem chamou vê pelo controle)
     no->esquerda->variavel = 0;  // Inicializa como nó vazio
     no->esquerda->valor = 0;      // Valor inicial
     no->esquerda->esquerda = no->esquerda->direita = NULL;  // Inicializa filhos
 
     // Atualiza a interpretação com verdadeiro para a variável
     interpretacao[var] = 1;
+    RASTRO_DESCER();  // 20ª ALTERAÇÃO: profundidade do rastro (sobe de novo em cada saída abaixo)
     
     // Chama recursivamente para continuar a busca
     if (SAT(f, interpretacao, no->esquerda)) 
     {
         no->valor = 1;  // Marca que este ramo levou a uma solução satisfatível
+        RASTRO_SUBIR();
         return true;
     }
 
     // Se a atribuição verdadeira falhou, libera o nó esquerdo
-    free(no->esquerda);
+    liberarRastreado(no->esquerda);
     no->esquerda = NULL;
 
     // Tenta atribuir falso (-1) à variável atual
-    no->direita = malloc(sizeof(BinaryTree));
+    estatisticas_thread.retrocessos++;
+    RASTRO(RASTRO_RETROCESSO, var);
+    no->direita = alocarRastreado(MEM_ARVORE, sizeof(BinaryTree));
+    if (!no->direita) {
+        RASTRO_SUBIR();
+        return false;
+    }
     no->direita->variavel = 0;    // Inicializa como nó vazio
     no->direita->valor = 0;       // Valor inicial
     no->direita->esquerda = no->direita->direita = NULL;  // Inicializa filhos
@@ -308,130 +1121,5841 @@ bool SAT(Formula *f, int *interpretacao, BinaryTree *no)
     if (SAT(f, interpretacao, no->direita)) 
     {
         no->valor = -1;  // Marca que este ramo levou a uma solução satisfatível
+        RASTRO_SUBIR();
         return true;
     }
 
     // Se ambas atribuições (verdadeiro e falso) falharem, faz backtracking
-    free(no->direita);      // Libera o nó direito
+    liberarRastreado(no->direita);  // Libera o nó direito
     no->direita = NULL;     // Reseta o ponteiro
     interpretacao[var] = 0; // Reseta a interpretação para a variável
+    RASTRO_SUBIR();
     
     return false;  // Retorna false indicando que não encontrou solução neste ramo
 }
 
-bool lerGrafo(const char *nome_arquivo, Grafo *g) { // 3ª ALTERAÇÃO: função lerGrafo
-    FILE *fp = fopen(nome_arquivo, "r");
-    if (!fp) {
-        perror("Erro ao abrir grafo.txt");
-        return false;
-    }
-
-    // Lê número de vértices
-    if (fscanf(fp, "%d", &g->n_vertices) != 1) {
-        fclose(fp);
-        printf("Erro ao ler número de vértices.\n");
-        return false;
-    }
+// 21ª ALTERAÇÃO: avaliação de várias interpretações de uma vez (bits fatiados)
+//
+// Um lote guarda até 256 interpretações completas "fatiadas" por variável: o bit j da palavra w
+// de bits[var * palavras + w] é o valor da variável na interpretação 64*w + j (1 = verdadeira).
+// Cada literal vira uma palavra inteira (a da variável ou o seu complemento) e a cláusula é o OU
+// dessas palavras, então uma passada pela arena avalia o lote todo, sem abs() nem desvio por
+// sinal. Com 4 palavras e AVX2 no processador, cada cláusula é avaliada num registrador de 256 bits.
 
-    // Lê número de arestas
-    if (fscanf(fp, "%d", &g->m_arestas) != 1) {
-        fclose(fp);
-        printf("Erro ao ler número de arestas.\n");
-        return false;
-    }
+#define MAX_PALAVRAS_LOTE 4    // Até 256 interpretações por lote
+#define BITS_CONTADOR_LOTE 32  // Planos do contador fatiado de cláusulas falsas
 
-    // Pular a linha de separador (*)
-    char buffer[100];
-    fgets(buffer, sizeof(buffer), fp);  // Consome o restante da linha anterior
-    fgets(buffer, sizeof(buffer), fp);  // Pula a linha com "*"
+typedef struct {
+    int num_vars;     // Variáveis da fórmula (o índice 0 não é usado)
+    int palavras;     // Palavras de 64 bits por variável (1 a MAX_PALAVRAS_LOTE)
+    uint64_t *bits;   // (num_vars + 1) * palavras palavras
+} LoteInterpretacoes;
 
-    // Lê as arestas
-    for (int i = 0; i < g->m_arestas; i++) {
-        int a, b;
-        if (fscanf(fp, "%d %d", &a, &b) != 2) {
-            fclose(fp);
-            printf("Erro ao ler aresta %d.\n", i + 1);
-            return false;
-        }
-        g->arestas[i][0] = a;
-        g->arestas[i][1] = b;
-    }
+/**
+ * Prepara um lote para 'quantidade' interpretações (arredondado para múltiplo de 64, até 256),
+ * todas com as variáveis falsas
+ * @return false se faltou memória
+ */
+bool criarLote(LoteInterpretacoes *l, int num_vars, int quantidade)
+{
+    int palavras = (quantidade + 63) / 64;
+    if (palavras < 1) palavras = 1;
+    if (palavras > MAX_PALAVRAS_LOTE) palavras = MAX_PALAVRAS_LOTE;
+    l->num_vars = num_vars;
+    l->palavras = palavras;
+    l->bits = alocarRastreadoZerado(MEM_INTERPRETACAO, ((size_t)num_vars + 1) * palavras * sizeof(uint64_t));
+    return l->bits != NULL;
+}
 
-    fclose(fp);
-    return true;
+void liberarLote(LoteInterpretacoes *l)
+{
+    liberarRastreado(l->bits);
+    l->bits = NULL;
 }
 
-void gerarCNF(Grafo *g, int k, const char *nome_arquivo) {
+// Copia uma interpretação comum (1/-1; 0 conta como falsa) para a posição 'indice' do lote
+void gravarNoLote(LoteInterpretacoes *l, int indice, const int *interpretacao)
+{
+    uint64_t bit = 1ULL << (indice % 64);
+    uint64_t *p = l->bits + indice / 64;
+    for (int var = 1; var <= l->num_vars; var++) {
+        if (interpretacao[var] == 1) p[(size_t)var * l->palavras] |= bit;
+        else p[(size_t)var * l->palavras] &= ~bit;
+    }
+}
+
+// Copia a interpretação 'indice' do lote para um vetor comum (1 ou -1)
+void lerDoLote(const LoteInterpretacoes *l, int indice, int *interpretacao)
+{
+    const uint64_t *p = l->bits + indice / 64;
+    for (int var = 1; var <= l->num_vars; var++) {
+        interpretacao[var] = (p[(size_t)var * l->palavras] >> (indice % 64)) & 1 ? 1 : -1;
+    }
+}
+
+/**
+ * Avalia uma cláusula em todas as interpretações do lote
+ * @param satisfeita Saída: uma palavra por grupo de 64 interpretações, bit ligado = cláusula verdadeira
+ */
+static inline void avaliarClausulaLote(const int *clausula, const LoteInterpretacoes *l, uint64_t *satisfeita)
+{
+    int palavras = l->palavras;
+    for (int w = 0; w < palavras; w++) satisfeita[w] = 0;
+    for (; *clausula != 0; clausula++) {
+        int sinal = *clausula >> 31;              // -1 se o literal é negativo, 0 se positivo
+        int var = (*clausula ^ sinal) - sinal;    // |literal| sem desvio
+        uint64_t inverter = (uint64_t)(int64_t)sinal;
+        const uint64_t *b = l->bits + (size_t)var * palavras;
+        for (int w = 0; w < palavras; w++) satisfeita[w] |= b[w] ^ inverter;
+    }
+}
+
+// Soma 1 no contador fatiado das interpretações marcadas em 'falsas' (vai-um plano a plano)
+static inline void contarFalsasLote(uint64_t *plano, int passo, uint64_t falsas)
+{
+    for (int b = 0; falsas && b < BITS_CONTADOR_LOTE; b++, plano += passo) {
+        uint64_t vai_um = *plano & falsas;
+        *plano ^= falsas;
+        falsas = vai_um;
+    }
+}
+
+// Caminho portátil de avaliarFormulaLote (planos[b * palavras + w] = bit b do contador)
+static void avaliarFormulaLoteEscalar(Formula *f, const LoteInterpretacoes *l, uint64_t *todas,
+                                      uint64_t *planos, uint64_t *por_clausula)
+{
+    int palavras = l->palavras;
+    uint64_t satisfeita[MAX_PALAVRAS_LOTE];
+    for (int w = 0; w < palavras; w++) todas[w] = ~0ULL;
+    for (int i = 0; i < f->num_clausulas; i++) {
+        avaliarClausulaLote(f->clausulas[i], l, satisfeita);
+        for (int w = 0; w < palavras; w++) {
+            todas[w] &= satisfeita[w];
+            if (planos) contarFalsasLote(planos + w, palavras, ~satisfeita[w]);
+            if (por_clausula) por_clausula[(size_t)i * palavras + w] = satisfeita[w];
+        }
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// Lote de 256 interpretações com AVX2: a cláusula inteira num registrador
+__attribute__((target("avx2")))
+static void avaliarFormulaLoteAVX2(Formula *f, const LoteInterpretacoes *l, uint64_t *todas,
+                                   uint64_t *planos, uint64_t *por_clausula)
+{
+    const __m256i uns = _mm256_set1_epi64x(-1);
+    __m256i acumulado = uns;
+    for (int i = 0; i < f->num_clausulas; i++) {
+        __m256i satisfeita = _mm256_setzero_si256();
+        for (const int *lit = f->clausulas[i]; *lit != 0; lit++) {
+            int sinal = *lit >> 31;
+            int var = (*lit ^ sinal) - sinal;
+            __m256i b = _mm256_loadu_si256((const __m256i*)(l->bits + (size_t)var * 4));
+            satisfeita = _mm256_or_si256(satisfeita, _mm256_xor_si256(b, _mm256_set1_epi64x(sinal)));
+        }
+        acumulado = _mm256_and_si256(acumulado, satisfeita);
+        if (por_clausula) _mm256_storeu_si256((__m256i*)(por_clausula + (size_t)i * 4), satisfeita);
+        if (planos) {
+            __m256i falsas = _mm256_andnot_si256(satisfeita, uns);
+            for (int b = 0; b < BITS_CONTADOR_LOTE && !_mm256_testz_si256(falsas, falsas); b++) {
+                __m256i *plano = (__m256i*)(planos + b * 4);
+                __m256i atual = _mm256_loadu_si256(plano);
+                __m256i vai_um = _mm256_and_si256(atual, falsas);
+                _mm256_storeu_si256(plano, _mm256_xor_si256(atual, falsas));
+                falsas = vai_um;
+            }
+        }
+    }
+    _mm256_storeu_si256((__m256i*)todas, acumulado);
+}
+#endif
+
+// O processador tem AVX2? (consultado uma vez; GCP_SEM_AVX2 força o caminho portátil)
+static bool temAVX2(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static int resposta = -1;
+    int r = __atomic_load_n(&resposta, __ATOMIC_RELAXED);
+    if (r < 0) {
+        r = !getenv("GCP_SEM_AVX2") && __builtin_cpu_supports("avx2");
+        __atomic_store_n(&resposta, r, __ATOMIC_RELAXED);
+    }
+    return r;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Avalia a fórmula em todas as interpretações do lote com uma passada pelas cláusulas
+ * @param f Fórmula
+ * @param l Lote de interpretações
+ * @param todas Saída: palavra w com o bit j ligado se a interpretação 64*w + j satisfaz a fórmula
+ * @param falsas Saída opcional (NULL = não contar): cláusulas falsas de cada interpretação (64 * palavras posições)
+ * @param por_clausula Saída opcional: num_clausulas * palavras palavras com o resultado de cada cláusula
+ * @return Quantas interpretações do lote satisfazem a fórmula
+ */
+int avaliarFormulaLote(Formula *f, const LoteInterpretacoes *l, uint64_t *todas, unsigned *falsas,
+                       uint64_t *por_clausula)
+{
+    uint64_t planos[BITS_CONTADOR_LOTE * MAX_PALAVRAS_LOTE];
+    uint64_t *p = falsas ? planos : NULL;
+    if (p) memset(planos, 0, sizeof(planos));
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (l->palavras == 4 && temAVX2()) avaliarFormulaLoteAVX2(f, l, todas, p, por_clausula);
+    else
+#endif
+    avaliarFormulaLoteEscalar(f, l, todas, p, por_clausula);
+
+    int palavras = l->palavras, satisfeitas = 0;
+    for (int w = 0; w < palavras; w++) satisfeitas += __builtin_popcountll(todas[w]);
+    for (int j = 0; falsas && j < 64 * palavras; j++) {
+        unsigned total = 0;
+        for (int b = 0; b < BITS_CONTADOR_LOTE; b++) {
+            total |= (unsigned)((planos[b * palavras + j / 64] >> (j % 64)) & 1) << b;
+        }
+        falsas[j] = total;
+    }
+    return satisfeitas;
+}
+
+static uint64_t proximoAleatorio(uint64_t *estado);  // 16ª ALTERAÇÃO (bateria de desempenho)
+
+/**
+ * Busca local em lote: 256 caminhadas aleatórias focadas (à la Schöning) andando juntas.
+ * A cada passo sorteia uma cláusula falsa em alguma interpretação e um literal dela, e troca a
+ * variável só nas interpretações em que essa cláusula está falsa. Depois reavalia apenas as
+ * cláusulas da variável (listas de ocorrência). A cada 3 * num_vars passos o lote é sorteado de novo.
+ * Só encontra soluções: terminar sem achar não prova nada.
+ * 27ª ALTERAÇÃO: com 'partida', o lote nasce dela (a interpretação 0 igual, as outras com cada
+ * variável trocada com chance 1/8); com 'menor_falsas', 'interpretacao' recebe a melhor
+ * interpretação vista mesmo sem solução (é a fase "SLS" do CDCL).
+ * @param f Fórmula
+ * @param passos Limite de passos
+ * @param semente Semente do sorteio
+ * @param partida Interpretação (1/-1) em torno da qual sortear, ou NULL
+ * @param interpretacao Saída: interpretação (1/-1) que satisfaz a fórmula, se achou
+ * @param menor_falsas Saída opcional: cláusulas falsas na melhor interpretação vista
+ * @return true se achou
+ */
+static bool buscaLocalLoteDe(Formula *f, long long passos, uint64_t semente, const int *partida,
+                             int *interpretacao, unsigned *menor_falsas)
+{
+    int n = f->num_literais, m = f->num_clausulas;
+    LoteInterpretacoes l;
+    if (m == 0 || !criarLote(&l, n, 64 * MAX_PALAVRAS_LOTE)) return false;
+    int palavras = l.palavras;
+
+    // Listas de ocorrência: cláusulas de cada variável em ocorrencias[inicio[var] .. inicio[var+1]-1]
+    size_t total = 0;
+    bool tem_vazia = false;
+    for (int i = 0; i < m; i++) {
+        const int *c = f->clausulas[i];
+        if (*c == 0) tem_vazia = true;
+        while (*c++ != 0) total++;
+    }
+    size_t *inicio = alocarRastreadoZerado(MEM_CLAUSULAS, ((size_t)n + 2) * sizeof(size_t));
+    int *ocorrencias = alocarRastreado(MEM_CLAUSULAS, (total > 0 ? total : 1) * sizeof(int));
+    uint64_t *satisfeita = alocarRastreado(MEM_INTERPRETACAO, (size_t)m * palavras * sizeof(uint64_t));
+    int *lista_falsas = alocarRastreado(MEM_CLAUSULAS, (size_t)m * sizeof(int));   // Falsas em alguma interpretação
+    int *posicao = alocarRastreado(MEM_CLAUSULAS, (size_t)m * sizeof(int));        // Posição em lista_falsas (-1 = fora)
+    unsigned falsas[64 * MAX_PALAVRAS_LOTE];                                        // Cláusulas falsas por interpretação
+    bool achou = false;
+    if (tem_vazia || !inicio || !ocorrencias || !satisfeita || !lista_falsas || !posicao) goto fim;
+
+    for (int i = 0; i < m; i++) {
+        for (const int *c = f->clausulas[i]; *c != 0; c++) inicio[abs(*c) + 1]++;
+    }
+    for (int var = 1; var <= n + 1; var++) inicio[var] += inicio[var - 1];
+    for (int i = 0; i < m; i++) {
+        for (const int *c = f->clausulas[i]; *c != 0; c++) ocorrencias[inicio[abs(*c)]++] = i;
+    }
+    for (int var = n; var >= 1; var--) inicio[var] = inicio[var - 1];  // Desfaz o avanço do preenchimento
+    inicio[0] = 0;
+
+    uint64_t estado = semente;
+    int tam_falsas = 0, achada = -1;
+    long long reinicio = 3LL * n, ate_reiniciar = 0;
+    for (long long passo = 0; passo < passos && achada < 0; passo++, ate_reiniciar--) {
+        if ((passo & 1023) == 0 && limiteEsgotado()) break;
+
+        if (ate_reiniciar <= 0) {
+            // Lote novo: sorteia as interpretações e avalia tudo de uma vez
+            for (size_t i = (size_t)palavras; i < ((size_t)n + 1) * palavras; i++) {
+                l.bits[i] = proximoAleatorio(&estado);
+                if (partida) {
+                    uint64_t base = partida[i / palavras] == 1 ? ~0ULL : 0;
+                    uint64_t ruido = l.bits[i] & proximoAleatorio(&estado) & proximoAleatorio(&estado);
+                    l.bits[i] = base ^ (i % palavras == 0 ? ruido & ~1ULL : ruido);
+                }
+            }
+            uint64_t todas[MAX_PALAVRAS_LOTE];
+            if (avaliarFormulaLote(f, &l, todas, falsas, satisfeita) > 0) {
+                for (int w = 0; w < palavras && achada < 0; w++) {
+                    if (todas[w]) achada = 64 * w + __builtin_ctzll(todas[w]);
+                }
+                break;
+            }
+            for (int j = 0; menor_falsas && j < 64 * palavras; j++) {
+                if (falsas[j] < *menor_falsas) {
+                    *menor_falsas = falsas[j];
+                    lerDoLote(&l, j, interpretacao);
+                }
+            }
+            tam_falsas = 0;
+            for (int i = 0; i < m; i++) {
+                bool falsa = false;
+                for (int w = 0; w < palavras; w++) falsa |= ~satisfeita[(size_t)i * palavras + w] != 0;
+                posicao[i] = falsa ? tam_falsas : -1;
+                if (falsa) lista_falsas[tam_falsas++] = i;
+            }
+            ate_reiniciar = reinicio;
+        }
+
+        // Sorteia uma cláusula falsa e um literal dela
+        int c = lista_falsas[proximoAleatorio(&estado) % (uint64_t)tam_falsas];
+        const int *clausula = f->clausulas[c];
+        int tam = 0;
+        while (clausula[tam] != 0) tam++;
+        int var = abs(clausula[proximoAleatorio(&estado) % (uint64_t)tam]);
+
+        // Troca a variável nas interpretações em que a cláusula está falsa
+        uint64_t trocadas[MAX_PALAVRAS_LOTE];
+        for (int w = 0; w < palavras; w++) {
+            trocadas[w] = ~satisfeita[(size_t)c * palavras + w];
+            l.bits[(size_t)var * palavras + w] ^= trocadas[w];
+        }
+
+        // Reavalia as cláusulas da variável e atualiza as contagens de cada interpretação
+        for (size_t j = inicio[var]; j < inicio[var + 1]; j++) {
+            int d = ocorrencias[j];
+            uint64_t novo[MAX_PALAVRAS_LOTE];
+            avaliarClausulaLote(f->clausulas[d], &l, novo);
+            bool falsa = false;
+            for (int w = 0; w < palavras; w++) {
+                uint64_t *antigo = &satisfeita[(size_t)d * palavras + w];
+                for (uint64_t x = *antigo & ~novo[w]; x; x &= x - 1) falsas[64 * w + __builtin_ctzll(x)]++;
+                for (uint64_t x = ~*antigo & novo[w]; x; x &= x - 1) falsas[64 * w + __builtin_ctzll(x)]--;
+                *antigo = novo[w];
+                falsa |= ~novo[w] != 0;
+            }
+            if (falsa && posicao[d] < 0) {
+                posicao[d] = tam_falsas;
+                lista_falsas[tam_falsas++] = d;
+            } else if (!falsa && posicao[d] >= 0) {
+                int ultima = lista_falsas[--tam_falsas];
+                lista_falsas[posicao[d]] = ultima;
+                posicao[ultima] = posicao[d];
+                posicao[d] = -1;
+            }
+        }
+
+        // Só as interpretações que andaram podem ter zerado (ou baixado) as cláusulas falsas
+        for (int w = 0; w < palavras && achada < 0; w++) {
+            for (uint64_t x = trocadas[w]; x && achada < 0; x &= x - 1) {
+                int j = 64 * w + __builtin_ctzll(x);
+                if (falsas[j] == 0) achada = j;
+                else if (menor_falsas && falsas[j] < *menor_falsas) {
+                    *menor_falsas = falsas[j];
+                    lerDoLote(&l, j, interpretacao);
+                }
+            }
+        }
+    }
+
+    if (achada >= 0) {
+        lerDoLote(&l, achada, interpretacao);
+        if (menor_falsas) *menor_falsas = 0;
+        achou = true;
+    }
+
+fim:
+    liberarRastreado(inicio);
+    liberarRastreado(ocorrencias);
+    liberarRastreado(satisfeita);
+    liberarRastreado(lista_falsas);
+    liberarRastreado(posicao);
+    liberarLote(&l);
+    return achou;
+}
+
+bool buscaLocalLote(Formula *f, long long passos, uint64_t semente, int *interpretacao)
+{
+    return buscaLocalLoteDe(f, passos, semente, NULL, interpretacao, NULL);
+}
+
+// 25ª ALTERAÇÃO: solver CDCL com minimização recursiva das cláusulas aprendidas
+//
+// O SAT() acima é um DPLL sem propagação: cada nó varre a fórmula inteira. O satCDCL propaga com
+// dois literais vigiados (e um literal bloqueador por vigia), aprende uma cláusula no 1º UIP a
+// cada conflito, volta direto ao nível que ela indica, escolhe variáveis pela atividade (VSIDS)
+// e reinicia na série de Luby. Nas fórmulas de coloração as cláusulas aprendidas saem longas,
+// porque as cores são equivalentes entre si; por isso a análise faz duas reduções:
+//  - minimização recursiva: um literal sai da cláusula se a sua razão, seguida pelo grafo de
+//    implicação, só chega a literais que já estão na cláusula (ou no nível 0);
+//  - fortalecimento durante a análise: se o resolvente de um passo tem o tamanho da razão usada
+//    menos um, ele é essa razão sem o literal resolvido, e a razão perde o literal ali mesmo.
+// As estatísticas trazem o tamanho médio das aprendidas antes e depois da minimização.
+// As aprendidas de LBD alto são descartadas aos poucos (e antes, se a memória chegar perto do
+// teto da 19ª ALTERAÇÃO). GCP_SAT=dpll volta ao SAT() recursivo, com a árvore de decisão.
+
+#define LITERAL_CDCL(x) ((x) > 0 ? 2 * (x) : -2 * (x) + 1)  // Literal do DIMACS -> índice (2v: v, 2v+1: ¬v)
+#define CABECALHO_CLAUSULA 3   // arena[c] = tamanho, arena[c+1] = espaço reservado, arena[c+2] = LBD*8 + marcas
+#define CLAUSULA_APRENDIDA 1
+#define CLAUSULA_REMOVIDA 2
+#define CLAUSULA_VIVIFICADA 4  // 26ª ALTERAÇÃO: já passou pela vivificação
+#define DESLOCAMENTO_LBD 3
+#define SEM_RAZAO (-1)
+#define REINICIO_BASE 100      // Conflitos da unidade da série de Luby
+#define REDUCAO_INICIAL 2000   // Conflitos até o primeiro descarte de aprendidas
+#define REDUCAO_PASSO 300      // Quanto esse intervalo cresce a cada descarte
+
+typedef struct {
+    int clausula;    // Posição da cláusula na arena
+    int bloqueador;  // Outro literal dela: se já é verdadeiro, a cláusula nem é visitada
+} Vigia;
+
+typedef struct {
+    Vigia *itens;
+    int n, cap;
+} ListaVigias;
+
+typedef struct {
+    int num_vars;
+    int *arena;                 // Cláusulas em sequência: cabeçalho + literais
+    size_t tam_arena, cap_arena;
+    int num_aprendidas;         // Aprendidas vivas
+    ListaVigias *vigias;        // vigias[l]: cláusulas que vigiam l (visitadas quando l fica falso)
+    signed char *valor;         // Por literal: 1 verdadeiro, -1 falso, 0 livre
+    int *nivel, *razao;         // Por variável: nível da atribuição e cláusula que a forçou
+    int *trilha, num_trilha, propagados;
+    int *inicio_nivel, nivel_atual;  // inicio_nivel[d]: posição da decisão do nível d na trilha
+    double *atividade, incremento;
+    int *heap, num_heap, *pos_heap;  // Variáveis por atividade (pos_heap = -1 fora do heap)
+    char *visto;
+    int *aprendida, num_aprendida;   // Cláusula montada pela análise (posição 0: literal do UIP)
+    int *pilha, *limpar, num_limpar; // Minimização
+    unsigned *selo_nivel, selo;      // Contagem de níveis distintos (LBD)
+    bool reduzir;                    // Memória perto do teto: descartar aprendidas no próximo reinício
+    bool falhou;                     // Faltou memória no meio da busca
+    long long propagacoes;           // 26ª ALTERAÇÃO: propagações deste solver (esforço do inprocessamento)
+    // 27ª ALTERAÇÃO: polaridade das decisões (valores 1/-1; 0 = sem valor)
+    int politica;                    // PoliticaPolaridade
+    signed char *fase_salva;         // Último valor de cada variável
+    signed char *fase_alvo;          // Valor na maior trilha sem conflito desde o último refaseamento
+    signed char *fase_melhor;        // Valor na maior trilha sem conflito da busca toda
+    int tamanho_alvo, tamanho_melhor;
+    long long refases[5];            // Refaseamentos por TipoRefase
+    // 28ª ALTERAÇÃO: decisão pelo grafo (vertices = NULL: só VSIDS)
+    const MapaVariaveis *vertices;
+    int *livres;                     // Por vértice: variáveis ainda sem valor (cores possíveis)
+    int *coloridos;                  // Por vértice: variáveis verdadeiras
+    int *uso_cor;                    // Por cor: vértices com essa cor
+} SolverCDCL;
+
+// Inclui um vigia na lista (a primeira alocação e o crescimento passam pela memória rastreada)
+static bool incluirVigia(ListaVigias *l, int clausula, int bloqueador)
+{
+    if (l->n == l->cap) {
+        int cap = l->cap ? 2 * l->cap : 4;
+        Vigia *novo = l->itens ? realocarRastreado(l->itens, (size_t)cap * sizeof(Vigia))
+                               : alocarRastreado(MEM_VIGIAS, (size_t)cap * sizeof(Vigia));
+        if (!novo) return false;
+        l->itens = novo;
+        l->cap = cap;
+    }
+    l->itens[l->n++] = (Vigia){ clausula, bloqueador };
+    return true;
+}
+
+static void retirarVigia(ListaVigias *l, int clausula)
+{
+    for (int i = 0; i < l->n; i++) {
+        if (l->itens[i].clausula == clausula) {
+            l->itens[i] = l->itens[--l->n];
+            return;
+        }
+    }
+}
+
+// Heap de máximo pela atividade
+static void heapSubir(SolverCDCL *s, int i)
+{
+    int v = s->heap[i];
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (s->atividade[s->heap[pai]] >= s->atividade[v]) break;
+        s->heap[i] = s->heap[pai];
+        s->pos_heap[s->heap[i]] = i;
+        i = pai;
+    }
+    s->heap[i] = v;
+    s->pos_heap[v] = i;
+}
+
+static void heapDescer(SolverCDCL *s, int i)
+{
+    int v = s->heap[i];
+    for (;;) {
+        int filho = 2 * i + 1;
+        if (filho >= s->num_heap) break;
+        if (filho + 1 < s->num_heap && s->atividade[s->heap[filho + 1]] > s->atividade[s->heap[filho]]) filho++;
+        if (s->atividade[s->heap[filho]] <= s->atividade[v]) break;
+        s->heap[i] = s->heap[filho];
+        s->pos_heap[s->heap[i]] = i;
+        i = filho;
+    }
+    s->heap[i] = v;
+    s->pos_heap[v] = i;
+}
+
+static void heapIncluir(SolverCDCL *s, int v)
+{
+    if (s->pos_heap[v] >= 0) return;
+    s->heap[s->num_heap] = v;
+    heapSubir(s, s->num_heap++);
+}
+
+static int heapRetirarMaior(SolverCDCL *s)
+{
+    int v = s->heap[0];
+    s->pos_heap[v] = -1;
+    if (--s->num_heap > 0) {
+        s->heap[0] = s->heap[s->num_heap];
+        heapDescer(s, 0);
+    }
+    return v;
+}
+
+static void aumentarAtividade(SolverCDCL *s, int v)
+{
+    if ((s->atividade[v] += s->incremento) > 1e100) {  // Reescala tudo para não estourar
+        for (int i = 1; i <= s->num_vars; i++) s->atividade[i] *= 1e-100;
+        s->incremento *= 1e-100;
+    }
+    if (s->pos_heap[v] >= 0) heapSubir(s, s->pos_heap[v]);
+}
+
+static void atribuirCDCL(SolverCDCL *s, int l, int razao)
+{
+    int v = l >> 1;
+    s->valor[l] = 1;
+    s->valor[l ^ 1] = -1;
+    s->nivel[v] = s->nivel_atual;
+    s->razao[v] = razao;
+    s->trilha[s->num_trilha++] = l;
+    if (s->vertices) {  // 28ª ALTERAÇÃO
+        int u = s->vertices->vertice[v];
+        s->livres[u]--;
+        if (!(l & 1)) {
+            s->coloridos[u]++;
+            s->uso_cor[s->vertices->cor[v]]++;
+        }
+    }
+}
+
+/**
+ * Copia uma cláusula (literais já no formato do CDCL) para o fim da arena e vigia as duas
+ * primeiras posições
+ * @return Posição na arena ou SEM_RAZAO se faltou memória
+ */
+static int novaClausulaCDCL(SolverCDCL *s, const int *lits, int n, int marcas)
+{
+    size_t ocupa = CABECALHO_CLAUSULA + (size_t)n;
+    if (s->tam_arena + ocupa > s->cap_arena) {
+        size_t cap = 2 * s->cap_arena;
+        if (cap < s->tam_arena + ocupa) cap = s->tam_arena + ocupa;
+        if (cap > INT_MAX) cap = INT_MAX;
+        // Perto do teto: cresce só o necessário e pede o descarte das aprendidas no próximo reinício
+        if (teto_memoria > 0 && __atomic_load_n(&bytes_rastreados, __ATOMIC_RELAXED) +
+            (long long)((cap - s->cap_arena) * sizeof(int)) > teto_memoria / 10 * 9) {
+            s->reduzir = true;
+            cap = s->tam_arena + ocupa;
+        }
+        int *nova = s->tam_arena + ocupa > INT_MAX ? NULL : realocarRastreado(s->arena, cap * sizeof(int));
+        if (!nova) return SEM_RAZAO;
+        s->arena = nova;
+        s->cap_arena = cap;
+    }
+    int c = (int)s->tam_arena;
+    s->arena[c] = n;
+    s->arena[c + 1] = n;
+    s->arena[c + 2] = marcas;
+    memcpy(s->arena + c + CABECALHO_CLAUSULA, lits, (size_t)n * sizeof(int));
+    s->tam_arena += ocupa;
+    if (!incluirVigia(&s->vigias[lits[0]], c, lits[1]) || !incluirVigia(&s->vigias[lits[1]], c, lits[0])) {
+        return SEM_RAZAO;
+    }
+    return c;
+}
+
+/**
+ * Propaga as atribuições da trilha que ainda não foram propagadas
+ * @return Cláusula em conflito ou SEM_RAZAO
+ */
+static int propagarCDCL(SolverCDCL *s)
+{
+    while (s->propagados < s->num_trilha) {
+        int falso = s->trilha[s->propagados++] ^ 1;
+        ListaVigias *lista = &s->vigias[falso];
+        Vigia *itens = lista->itens;
+        int i = 0, j = 0, n = lista->n;
+        while (i < n) {
+            Vigia w = itens[i++];
+            if (s->valor[w.bloqueador] == 1) {
+                itens[j++] = w;
+                continue;
+            }
+            int *lits = s->arena + w.clausula + CABECALHO_CLAUSULA;
+            int tam = s->arena[w.clausula];
+            if (lits[0] == falso) {  // O literal falso fica na posição 1
+                lits[0] = lits[1];
+                lits[1] = falso;
+            }
+            int primeiro = lits[0];
+            if (primeiro != w.bloqueador && s->valor[primeiro] == 1) {
+                itens[j++] = (Vigia){ w.clausula, primeiro };
+                continue;
+            }
+            // Procura outro literal não falso para vigiar
+            bool achou = false;
+            for (int k = 2; k < tam; k++) {
+                if (s->valor[lits[k]] != -1) {
+                    lits[1] = lits[k];
+                    lits[k] = falso;
+                    if (!incluirVigia(&s->vigias[lits[1]], w.clausula, primeiro)) s->falhou = true;
+                    achou = true;
+                    break;
+                }
+            }
+            if (achou) continue;
+
+            itens[j++] = (Vigia){ w.clausula, primeiro };
+            if (s->valor[primeiro] == -1) {  // Conflito: os vigias que faltam ficam como estavam
+                while (i < n) itens[j++] = itens[i++];
+                lista->n = j;
+                s->propagados = s->num_trilha;
+                return w.clausula;
+            }
+            atribuirCDCL(s, primeiro, w.clausula);
+            estatisticas_thread.propagacoes++;
+            s->propagacoes++;
+        }
+        lista->n = j;
+    }
+    return SEM_RAZAO;
+}
+
+// Desfaz as atribuições acima do nível (as variáveis voltam ao heap)
+static void voltarAoNivel(SolverCDCL *s, int nivel)
+{
+    if (s->nivel_atual <= nivel) return;
+    for (int i = s->num_trilha - 1; i >= s->inicio_nivel[nivel + 1]; i--) {
+        int l = s->trilha[i];
+        s->valor[l] = s->valor[l ^ 1] = 0;
+        s->razao[l >> 1] = SEM_RAZAO;
+        s->fase_salva[l >> 1] = (l & 1) ? -1 : 1;  // 27ª ALTERAÇÃO: fase salva
+        if (s->vertices) {  // 28ª ALTERAÇÃO
+            int u = s->vertices->vertice[l >> 1];
+            s->livres[u]++;
+            if (!(l & 1)) {
+                s->coloridos[u]--;
+                s->uso_cor[s->vertices->cor[l >> 1]]--;
+            }
+        }
+        heapIncluir(s, l >> 1);
+    }
+    s->num_trilha = s->propagados = s->inicio_nivel[nivel + 1];
+    s->nivel_atual = nivel;
+}
+
+static inline unsigned nivelAbstrato(const SolverCDCL *s, int v)
+{
+    return 1u << (s->nivel[v] & 31);
+}
+
+/**
+ * Minimização recursiva: p é redundante se todo caminho pela sua razão termina em literais
+ * que já estão na cláusula aprendida (marcados em visto) ou no nível 0. 'abstrato' tem um bit
+ * por nível presente na cláusula e corta cedo os caminhos que saem desses níveis.
+ */
+static bool literalRedundante(SolverCDCL *s, int p, unsigned abstrato)
+{
+    int topo = 0, limpar_antes = s->num_limpar;
+    s->pilha[topo++] = p;
+    while (topo > 0) {
+        int c = s->razao[s->pilha[--topo] >> 1];
+        int *lits = s->arena + c + CABECALHO_CLAUSULA;
+        for (int j = 1; j < s->arena[c]; j++) {
+            int u = lits[j] >> 1;
+            if (s->visto[u] || s->nivel[u] == 0) continue;
+            if (s->razao[u] != SEM_RAZAO && (nivelAbstrato(s, u) & abstrato)) {
+                s->visto[u] = 1;
+                s->pilha[topo++] = lits[j];
+                s->limpar[s->num_limpar++] = lits[j];
+            } else {
+                for (int i = limpar_antes; i < s->num_limpar; i++) s->visto[s->limpar[i] >> 1] = 0;
+                s->num_limpar = limpar_antes;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Tira da razão c o literal que ela implicou (posição 0). Só é chamada quando sobram ao menos
+ * dois literais do nível atual, que passam a ser os vigiados: voltando do conflito, os dois
+ * ficam livres e a cláusula continua bem vigiada.
+ */
+static void fortalecerRazao(SolverCDCL *s, int c)
+{
+    int *lits = s->arena + c + CABECALHO_CLAUSULA;
+    int tam = s->arena[c];
+    retirarVigia(&s->vigias[lits[0]], c);
+    retirarVigia(&s->vigias[lits[1]], c);
+    lits[0] = lits[tam - 1];
+    s->arena[c] = --tam;
+    for (int j = 0, a = 0; j < tam && a < 2; j++) {
+        if (s->nivel[lits[j] >> 1] == s->nivel_atual) {
+            int t = lits[a];
+            lits[a++] = lits[j];
+            lits[j] = t;
+        }
+    }
+    if (!incluirVigia(&s->vigias[lits[0]], c, lits[1]) || !incluirVigia(&s->vigias[lits[1]], c, lits[0])) {
+        s->falhou = true;
+    }
+    estatisticas_thread.fortalecidas++;
+}
+
+/**
+ * Análise do conflito no 1º UIP, com fortalecimento das razões e minimização recursiva
+ * @return Nível para onde voltar; a cláusula fica em s->aprendida (posição 1: o literal desse nível)
+ */
+static int analisarConflito(SolverCDCL *s, int conflito)
+{
+    int contador = 0, p = -1, indice = s->num_trilha - 1, c = conflito;
+    s->num_aprendida = 1;
+    do {
+        int *lits = s->arena + c + CABECALHO_CLAUSULA;
+        int tam = s->arena[c], fora_do_zero = 0;
+        for (int j = p == -1 ? 0 : 1; j < tam; j++) {
+            int q = lits[j], v = q >> 1;
+            if (s->nivel[v] == 0) continue;
+            fora_do_zero++;
+            if (!s->visto[v]) {
+                s->visto[v] = 1;
+                aumentarAtividade(s, v);
+                if (s->nivel[v] >= s->nivel_atual) contador++;
+                else s->aprendida[s->num_aprendida++] = q;
+            }
+        }
+        // O resolvente (contador literais do nível atual + os de baixo) é c sem p?
+        if (p != -1 && contador > 1 && fora_do_zero == tam - 1 && contador + s->num_aprendida - 1 == tam - 1) {
+            fortalecerRazao(s, c);
+        }
+        while (!s->visto[s->trilha[indice--] >> 1]) {}
+        p = s->trilha[indice + 1];
+        c = s->razao[p >> 1];
+        s->visto[p >> 1] = 0;
+        contador--;
+    } while (contador > 0);
+    s->aprendida[0] = p ^ 1;
+
+    // Minimização recursiva (os literais de baixo continuam marcados em visto)
+    int antes = s->num_aprendida;
+    unsigned abstrato = 0;
+    s->num_limpar = 0;
+    for (int i = 1; i < antes; i++) {
+        s->limpar[s->num_limpar++] = s->aprendida[i];
+        abstrato |= nivelAbstrato(s, s->aprendida[i] >> 1);
+    }
+    int n = 1;
+    for (int i = 1; i < antes; i++) {
+        int q = s->aprendida[i];
+        if (s->razao[q >> 1] == SEM_RAZAO || !literalRedundante(s, q, abstrato)) s->aprendida[n++] = q;
+    }
+    s->num_aprendida = n;
+    for (int i = 0; i < s->num_limpar; i++) s->visto[s->limpar[i] >> 1] = 0;
+    estatisticas_thread.aprendidas++;
+    estatisticas_thread.literais_antes += antes;
+    estatisticas_thread.literais_depois += n;
+
+    if (n == 1) return 0;
+    int maior = 1;
+    for (int i = 2; i < n; i++) {
+        if (s->nivel[s->aprendida[i] >> 1] > s->nivel[s->aprendida[maior] >> 1]) maior = i;
+    }
+    int t = s->aprendida[1];
+    s->aprendida[1] = s->aprendida[maior];
+    s->aprendida[maior] = t;
+    return s->nivel[s->aprendida[1] >> 1];
+}
+
+// LBD: quantos níveis de decisão distintos a cláusula aprendida toca
+static int calcularLBD(SolverCDCL *s)
+{
+    int lbd = 0;
+    s->selo++;
+    for (int i = 0; i < s->num_aprendida; i++) {
+        int d = s->nivel[s->aprendida[i] >> 1];
+        if (s->selo_nivel[d] != s->selo) {
+            s->selo_nivel[d] = s->selo;
+            lbd++;
+        }
+    }
+    return lbd;
+}
+
+/**
+ * Tira da arena as cláusulas removidas (no próprio bloco, de trás para frente não há
+ * sobreposição) e refaz todos os vigias. Só no nível 0, quando nenhuma razão importa mais.
+ */
+static bool compactarArena(SolverCDCL *s)
+{
+    size_t destino = 0;
+    for (size_t c = 0; c < s->tam_arena; ) {
+        size_t proxima = c + CABECALHO_CLAUSULA + (size_t)s->arena[c + 1];
+        if (!(s->arena[c + 2] & CLAUSULA_REMOVIDA)) {
+            int tam = s->arena[c];
+            if (destino != c) memmove(s->arena + destino, s->arena + c, (CABECALHO_CLAUSULA + (size_t)tam) * sizeof(int));
+            s->arena[destino + 1] = tam;  // O espaço que o fortalecimento liberou também sai
+            destino += CABECALHO_CLAUSULA + (size_t)tam;
+        }
+        c = proxima;
+    }
+    s->tam_arena = destino;
+    for (int l = 2; l < 2 * (s->num_vars + 1); l++) s->vigias[l].n = 0;
+    for (int i = 0; i < s->num_trilha; i++) s->razao[s->trilha[i] >> 1] = SEM_RAZAO;
+    for (size_t c = 0; c < s->tam_arena; c += CABECALHO_CLAUSULA + (size_t)s->arena[c + 1]) {
+        int *lits = s->arena + c + CABECALHO_CLAUSULA;
+        if (!incluirVigia(&s->vigias[lits[0]], (int)c, lits[1]) || !incluirVigia(&s->vigias[lits[1]], (int)c, lits[0])) {
+            return false;
+        }
+    }
+    int *justa = realocarRastreado(s->arena, (s->tam_arena + 1) * sizeof(int));
+    if (justa) {
+        s->arena = justa;
+        s->cap_arena = s->tam_arena + 1;
+    }
+    return true;
+}
+
+typedef struct {
+    int lbd, tamanho, clausula;
+} AprendidaOrdem;
+
+// Piores primeiro: LBD maior e, no empate, mais longa
+static int compararAprendidas(const void *a, const void *b)
+{
+    const AprendidaOrdem *x = a, *y = b;
+    if (x->lbd != y->lbd) return y->lbd - x->lbd;
+    return y->tamanho - x->tamanho;
+}
+
+/**
+ * Descarta a pior metade das aprendidas com LBD > 2 e compacta a arena (no nível 0)
+ * @return false se faltou memória
+ */
+static bool reduzirAprendidas(SolverCDCL *s)
+{
+    AprendidaOrdem *lista = malloc(((size_t)s->num_aprendidas + 1) * sizeof(AprendidaOrdem));
+    if (!lista) return false;
+    int n = 0;
+    for (size_t c = 0; c < s->tam_arena; c += CABECALHO_CLAUSULA + (size_t)s->arena[c + 1]) {
+        int marcas = s->arena[c + 2];
+        if ((marcas & CLAUSULA_APRENDIDA) && !(marcas & CLAUSULA_REMOVIDA) && (marcas >> DESLOCAMENTO_LBD) > 2) {
+            lista[n++] = (AprendidaOrdem){ marcas >> DESLOCAMENTO_LBD, s->arena[c], (int)c };
+        }
+    }
+    qsort(lista, (size_t)n, sizeof(AprendidaOrdem), compararAprendidas);
+    for (int i = 0; i < n / 2; i++) {
+        s->arena[lista[i].clausula + 2] |= CLAUSULA_REMOVIDA;
+        s->num_aprendidas--;
+    }
+    free(lista);
+    return compactarArena(s);
+}
+
+// Série de Luby (1 1 2 1 1 2 4 1 1 2 ...): tamanho da rodada x entre reinícios
+static long long luby(int x)
+{
+    int tamanho = 1, expoente = 0;
+    while (tamanho < x + 1) {
+        expoente++;
+        tamanho = 2 * tamanho + 1;
+    }
+    while (tamanho - 1 != x) {
+        tamanho = (tamanho - 1) >> 1;
+        expoente--;
+        x %= tamanho;
+    }
+    return 1LL << expoente;
+}
+
+// 26ª ALTERAÇÃO: inprocessamento (rodadas de simplificação dentro da busca do CDCL)
+//
+// De tempos em tempos (INPROCESSAMENTO_CONFLITOS conflitos, num reinício, no nível 0) a busca
+// para e simplifica a própria base de cláusulas:
+//  - cláusulas satisfeitas no nível 0 saem, e literais falsos no nível 0 saem das que ficam;
+//  - aprendidas contidas em outras aprendidas apagam as maiores (subsunção, com assinaturas de
+//    64 bits e listas de ocorrência pelo literal mais raro);
+//  - vivificação: cada literal de uma cláusula C é negado em sequência, com propagação (e sem C);
+//    um conflito ou um literal já verdadeiro encurta C até ali, e um literal que ficou falso sai.
+// O esforço de cada rodada é ESFORCO_INPROCESSAMENTO% das propagações da busca desde a rodada
+// anterior (cada propagação da vivificação e cada comparação da subsunção gastam uma unidade),
+// então o inprocessamento nunca passa de uma fração fixa do trabalho. A vivificação começa
+// pelas aprendidas de LBD baixo e continua pelas originais de onde parou na rodada anterior.
+// GCP_INPROCESSAMENTO=0 desliga as rodadas.
+
+#define INPROCESSAMENTO_CONFLITOS 5000  // Conflitos entre rodadas (o intervalo cresce 10% a cada uma)
+#define ESFORCO_INPROCESSAMENTO 10      // Porcentagem das propagações da busca
+#define ESFORCO_MINIMO 20000            // Unidades de esforço de qualquer rodada
+
+// Uma cláusula na subsunção: posição na arena, tamanho e assinatura (bit l % 64 de cada literal)
+typedef struct {
+    int clausula, tamanho;
+    uint64_t assinatura;
+} CandidataSubsuncao;
+
+static int compararCandidatas(const void *a, const void *b)
+{
+    const CandidataSubsuncao *x = a, *y = b;
+    return x->tamanho - y->tamanho;
+}
+
+/**
+ * Tira as cláusulas satisfeitas no nível 0 e os literais falsos no nível 0 das demais
+ * @return false se uma cláusula ficou vazia (fórmula insatisfatível)
+ */
+static bool limparNivelZero(SolverCDCL *s)
+{
+    for (size_t c = 0; c < s->tam_arena; c += CABECALHO_CLAUSULA + (size_t)s->arena[c + 1]) {
+        if (s->arena[c + 2] & CLAUSULA_REMOVIDA) continue;
+        int *lits = s->arena + c + CABECALHO_CLAUSULA;
+        int tam = s->arena[c], m = 0;
+        bool satisfeita = false;
+        for (int j = 0; j < tam && !satisfeita; j++) {
+            if (s->valor[lits[j]] == 1) satisfeita = true;
+            else if (s->valor[lits[j]] == 0) lits[m++] = lits[j];
+        }
+        if (!satisfeita && m == 0) return false;
+        if (satisfeita || m == 1) {
+            if (!satisfeita) atribuirCDCL(s, lits[0], SEM_RAZAO);  // Unitária (não deveria sobrar após propagar)
+            s->arena[c + 2] |= CLAUSULA_REMOVIDA;
+            if (s->arena[c + 2] & CLAUSULA_APRENDIDA) s->num_aprendidas--;
+            estatisticas_thread.satisfeitas_removidas++;
+            continue;
+        }
+        estatisticas_thread.literais_removidos += tam - m;
+        s->arena[c] = m;
+    }
+    return true;
+}
+
+/**
+ * Subsunção entre as aprendidas: cada uma, da menor para a maior, procura pelo seu literal
+ * mais raro as aprendidas que a contêm e as remove
+ * @return false se faltou memória (nada é alterado)
+ */
+static bool subsumirAprendidas(SolverCDCL *s, long long *orcamento)
+{
+    int n = 0, num_lits = 2 * (s->num_vars + 1);
+    CandidataSubsuncao *lista = malloc(((size_t)s->num_aprendidas + 1) * sizeof(CandidataSubsuncao));
+    int *inicio = calloc((size_t)num_lits + 1, sizeof(int));
+    if (!lista || !inicio) {
+        free(lista);
+        free(inicio);
+        return false;
+    }
+    size_t total = 0;
+    for (size_t c = 0; c < s->tam_arena; c += CABECALHO_CLAUSULA + (size_t)s->arena[c + 1]) {
+        int marcas = s->arena[c + 2];
+        if (!(marcas & CLAUSULA_APRENDIDA) || (marcas & CLAUSULA_REMOVIDA)) continue;
+        uint64_t assinatura = 0;
+        for (int j = 0; j < s->arena[c]; j++) {
+            int l = s->arena[c + CABECALHO_CLAUSULA + j];
+            assinatura |= 1ULL << (l & 63);
+            inicio[l + 1]++;
+        }
+        total += (size_t)s->arena[c];
+        lista[n++] = (CandidataSubsuncao){ (int)c, s->arena[c], assinatura };
+    }
+    qsort(lista, (size_t)n, sizeof(CandidataSubsuncao), compararCandidatas);
+
+    // Listas de ocorrência (índices em 'lista') no formato CSR
+    int *ocorrencias = malloc((total + 1) * sizeof(int));
+    if (!ocorrencias) {
+        free(lista);
+        free(inicio);
+        return false;
+    }
+    for (int l = 0; l < num_lits; l++) inicio[l + 1] += inicio[l];
+    int *proximo = malloc((size_t)num_lits * sizeof(int));
+    if (!proximo) {
+        free(lista);
+        free(inicio);
+        free(ocorrencias);
+        return false;
+    }
+    memcpy(proximo, inicio, (size_t)num_lits * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        const int *lits = s->arena + lista[i].clausula + CABECALHO_CLAUSULA;
+        for (int j = 0; j < lista[i].tamanho; j++) ocorrencias[proximo[lits[j]]++] = i;
+    }
+    free(proximo);
+
+    for (int i = 0; i < n && *orcamento > 0; i++) {
+        int c = lista[i].clausula;
+        if (s->arena[c + 2] & CLAUSULA_REMOVIDA) continue;
+        const int *lits = s->arena + c + CABECALHO_CLAUSULA;
+        int raro = lits[0];
+        for (int j = 1; j < lista[i].tamanho; j++) {
+            if (inicio[lits[j] + 1] - inicio[lits[j]] < inicio[raro + 1] - inicio[raro]) raro = lits[j];
+        }
+        for (int j = 0; j < lista[i].tamanho; j++) s->visto[lits[j]] = 1;
+        for (int o = inicio[raro]; o < inicio[raro + 1]; o++) {
+            const CandidataSubsuncao *d = &lista[ocorrencias[o]];
+            if (d->clausula == c || (s->arena[d->clausula + 2] & CLAUSULA_REMOVIDA) ||
+                (lista[i].assinatura & ~d->assinatura) != 0) {
+                continue;
+            }
+            (*orcamento)--;
+            const int *lits_d = s->arena + d->clausula + CABECALHO_CLAUSULA;
+            int comuns = 0;
+            for (int j = 0; j < d->tamanho; j++) comuns += s->visto[lits_d[j]];
+            if (comuns == lista[i].tamanho) {
+                s->arena[d->clausula + 2] |= CLAUSULA_REMOVIDA;
+                s->num_aprendidas--;
+                estatisticas_thread.subsumidas++;
+            }
+        }
+        for (int j = 0; j < lista[i].tamanho; j++) s->visto[lits[j]] = 0;
+    }
+    free(lista);
+    free(inicio);
+    free(ocorrencias);
+    return true;
+}
+
+/**
+ * Vivifica a cláusula c (no nível 0, com os vigias dela retirados)
+ * @return 1 ok, 0 fórmula insatisfatível, -1 sem memória
+ */
+static int vivificarClausula(SolverCDCL *s, int c, long long *orcamento)
+{
+    int *lits = s->arena + c + CABECALHO_CLAUSULA;
+    int tam = s->arena[c], m = 0;
+    bool satisfeita = false;
+    long long propagacoes_antes = s->propagacoes;
+    retirarVigia(&s->vigias[lits[0]], c);
+    retirarVigia(&s->vigias[lits[1]], c);
+
+    for (int j = 0; j < tam; j++) {
+        int l = lits[j];
+        if (s->valor[l] == -1) continue;  // Falso com os anteriores negados: sobra
+        if (s->valor[l] == 1) {           // Verdadeiro: a cláusula termina aqui
+            if (s->nivel[l >> 1] == 0) satisfeita = true;
+            s->aprendida[m++] = l;
+            break;
+        }
+        s->aprendida[m++] = l;
+        if (j == tam - 1) break;
+        s->inicio_nivel[++s->nivel_atual] = s->num_trilha;
+        atribuirCDCL(s, l ^ 1, SEM_RAZAO);
+        if (propagarCDCL(s) != SEM_RAZAO) break;  // Os literais até aqui já bastam
+    }
+    voltarAoNivel(s, 0);
+    *orcamento -= 1 + s->propagacoes - propagacoes_antes;
+    s->arena[c + 2] |= CLAUSULA_VIVIFICADA;
+    if (m == 0) return 0;  // Todos falsos no nível 0 (unitárias achadas nesta rodada)
+
+    if (m < tam && !satisfeita) {
+        estatisticas_thread.vivificadas++;
+        estatisticas_thread.literais_removidos += tam - m;
+        memcpy(lits, s->aprendida, (size_t)m * sizeof(int));
+        s->arena[c] = tam = m;
+    }
+    if (satisfeita || tam == 1) {
+        s->arena[c + 2] |= CLAUSULA_REMOVIDA;
+        if (s->arena[c + 2] & CLAUSULA_APRENDIDA) s->num_aprendidas--;
+        if (satisfeita) return 1;
+        if (s->valor[lits[0]] == -1) return 0;
+        if (s->valor[lits[0]] == 0) atribuirCDCL(s, lits[0], SEM_RAZAO);
+        return propagarCDCL(s) == SEM_RAZAO ? 1 : 0;
+    }
+    if (!incluirVigia(&s->vigias[lits[0]], c, lits[1]) || !incluirVigia(&s->vigias[lits[1]], c, lits[0])) return -1;
+    return 1;
+}
+
+/**
+ * Uma rodada de inprocessamento (no nível 0, com tudo propagado)
+ * @param orcamento Unidades de esforço (propagações e comparações)
+ * @return 1 ok, 0 fórmula insatisfatível, -1 sem memória
+ */
+static int inprocessarCDCL(SolverCDCL *s, long long orcamento)
+{
+    estatisticas_thread.rodadas_inprocessamento++;
+    if (!limparNivelZero(s)) return 0;
+    if (!subsumirAprendidas(s, &orcamento)) return -1;
+    if (!compactarArena(s)) return -1;
+    if (propagarCDCL(s) != SEM_RAZAO) return 0;  // Unitárias que a limpeza achou
+
+    // Vivificação: aprendidas ainda não vivificadas, LBD menor primeiro; depois as originais
+    AprendidaOrdem *lista = malloc(((size_t)s->num_aprendidas + 1) * sizeof(AprendidaOrdem));
+    if (!lista) return -1;
+    int n = 0;
+    for (size_t c = 0; c < s->tam_arena; c += CABECALHO_CLAUSULA + (size_t)s->arena[c + 1]) {
+        int marcas = s->arena[c + 2];
+        if ((marcas & CLAUSULA_APRENDIDA) && !(marcas & CLAUSULA_VIVIFICADA) && s->arena[c] > 2) {
+            lista[n++] = (AprendidaOrdem){ marcas >> DESLOCAMENTO_LBD, s->arena[c], (int)c };
+        }
+    }
+    qsort(lista, (size_t)n, sizeof(AprendidaOrdem), compararAprendidas);  // Piores primeiro: percorre do fim
+    int resultado = 1;
+    for (int i = n - 1; i >= 0 && resultado == 1 && orcamento > 0; i--) {
+        if (!(s->arena[lista[i].clausula + 2] & CLAUSULA_REMOVIDA)) {
+            resultado = vivificarClausula(s, lista[i].clausula, &orcamento);
+        }
+    }
+    free(lista);
+    for (size_t c = 0; c < s->tam_arena && resultado == 1 && orcamento > 0;
+         c += CABECALHO_CLAUSULA + (size_t)s->arena[c + 1]) {
+        int marcas = s->arena[c + 2];
+        if (!(marcas & (CLAUSULA_APRENDIDA | CLAUSULA_REMOVIDA | CLAUSULA_VIVIFICADA)) && s->arena[c] > 2) {
+            resultado = vivificarClausula(s, (int)c, &orcamento);
+        }
+    }
+    return resultado;
+}
+
+// 27ª ALTERAÇÃO: polaridade das decisões do CDCL (fase salva, fase alvo e refaseamento)
+//
+// O SAT() sempre tenta verdadeiro primeiro; nas fórmulas de coloração isso liga várias cores do
+// mesmo vértice de uma vez e a busca passa o tempo desfazendo. GCP_POLARIDADE escolhe o valor
+// que cada decisão tenta:
+//   original   sempre falso (numa coloração só 1/K das variáveis é verdadeira)
+//   invertida  sempre verdadeiro (como o SAT())
+//   salva      o último valor que a variável teve (fase salva)
+//   alvo       (padrão) o valor na maior trilha sem conflito desde o último refaseamento, ou a
+//              fase salva; a cada REFASE_INTERVALO * r conflitos (r = refaseamentos já feitos + 1)
+//              as fases salvas são trocadas, em ciclo, por: original, melhor, invertida, melhor,
+//              aleatória, melhor, busca local (SLS), melhor. "Melhor" é a maior trilha sem
+//              conflito da busca toda; a SLS roda a busca local em lote em torno das fases salvas e
+//              fica com a interpretação de menos cláusulas falsas. GCP_REFASE=0 desliga o refaseamento.
+// As estatísticas mostram a política e quantos refaseamentos de cada tipo houve; a bateria
+// (--bench -m sat) compara as políticas rodando com cada valor de GCP_POLARIDADE.
+
+typedef enum { POLARIDADE_ORIGINAL, POLARIDADE_INVERTIDA, POLARIDADE_SALVA, POLARIDADE_ALVO } PoliticaPolaridade;
+typedef enum { REFASE_ORIGINAL, REFASE_MELHOR, REFASE_INVERTIDA, REFASE_ALEATORIA, REFASE_SLS, NUM_REFASES } TipoRefase;
+
+static const char *const nome_polaridade[] = { "original", "invertida", "salva", "alvo" };
+static const char *const nome_refase[NUM_REFASES] = { "original", "melhor", "invertida", "aleatoria", "sls" };
+static const TipoRefase ciclo_refases[] = {
+    REFASE_ORIGINAL, REFASE_MELHOR, REFASE_INVERTIDA, REFASE_MELHOR,
+    REFASE_ALEATORIA, REFASE_MELHOR, REFASE_SLS, REFASE_MELHOR
+};
+long long refases_total[NUM_REFASES];  // Somado com operações atômicas ao fim de cada satCDCL
+
+#define REFASE_INTERVALO 1000  // Conflitos até o primeiro refaseamento
+#define PASSOS_SLS_POR_VARIAVEL 20
+#define MAX_PASSOS_SLS 200000
+
+// Política de GCP_POLARIDADE (padrão: alvo)
+static PoliticaPolaridade politicaPolaridade(void)
+{
+    const char *env = getenv("GCP_POLARIDADE");
+    for (int p = 0; env && p < (int)(sizeof(nome_polaridade) / sizeof(nome_polaridade[0])); p++) {
+        if (strcmp(env, nome_polaridade[p]) == 0) return (PoliticaPolaridade)p;
+    }
+    return POLARIDADE_ALVO;
+}
+
+// Copia os valores da trilha[0 .. tamanho-1] para 'fase'
+static void copiarTrilha(const SolverCDCL *s, signed char *fase, int tamanho)
+{
+    for (int i = 0; i < tamanho; i++) fase[s->trilha[i] >> 1] = (s->trilha[i] & 1) ? -1 : 1;
+}
+
+/**
+ * Registra uma trilha sem conflito de 'tamanho' atribuições: se é a maior desde o último
+ * refaseamento vira a fase alvo, e se é a maior de todas vira a melhor fase
+ */
+static void atualizarAlvo(SolverCDCL *s, int tamanho)
+{
+    if (s->politica != POLARIDADE_ALVO) return;
+    if (tamanho > s->tamanho_alvo) {
+        copiarTrilha(s, s->fase_alvo, tamanho);
+        s->tamanho_alvo = tamanho;
+    }
+    if (tamanho > s->tamanho_melhor) {
+        copiarTrilha(s, s->fase_melhor, tamanho);
+        s->tamanho_melhor = tamanho;
+    }
+}
+
+// Literal que a decisão sobre v tenta primeiro
+static int literalDecisao(const SolverCDCL *s, int v)
+{
+    int valor;
+    switch (s->politica) {
+        case POLARIDADE_ORIGINAL:  valor = -1; break;
+        case POLARIDADE_INVERTIDA: valor = 1; break;
+        case POLARIDADE_SALVA:     valor = s->fase_salva[v]; break;
+        default:                   valor = s->fase_alvo[v] ? s->fase_alvo[v] : s->fase_salva[v]; break;
+    }
+    return valor > 0 ? 2 * v : 2 * v + 1;
+}
+
+/**
+ * Troca as fases salvas conforme o tipo e recomeça a fase alvo (no nível 0)
+ * @param f Fórmula original (para a busca local)
+ */
+static void refasear(SolverCDCL *s, Formula *f, TipoRefase tipo, uint64_t *estado)
+{
+    int n = s->num_vars;
+    switch (tipo) {
+        case REFASE_ORIGINAL:
+        case REFASE_INVERTIDA:
+            memset(s->fase_salva + 1, tipo == REFASE_ORIGINAL ? -1 : 1, (size_t)n);
+            break;
+        case REFASE_ALEATORIA:
+            for (int v = 1; v <= n; v++) s->fase_salva[v] = (proximoAleatorio(estado) & 1) ? 1 : -1;
+            break;
+        case REFASE_MELHOR:
+            for (int v = 1; v <= n; v++) {
+                if (s->fase_melhor[v]) s->fase_salva[v] = s->fase_melhor[v];
+            }
+            s->tamanho_melhor = 0;
+            break;
+        case REFASE_SLS: {
+            int *partida = malloc(((size_t)n + 1) * sizeof(int));
+            int *melhor = malloc(((size_t)n + 1) * sizeof(int));
+            unsigned menor = UINT_MAX;
+            if (partida && melhor) {
+                for (int v = 1; v <= n; v++) partida[v] = s->fase_salva[v];
+                long long passos = (long long)PASSOS_SLS_POR_VARIAVEL * n;
+                buscaLocalLoteDe(f, passos < MAX_PASSOS_SLS ? passos : MAX_PASSOS_SLS, proximoAleatorio(estado),
+                                 partida, melhor, &menor);
+                for (int v = 1; menor != UINT_MAX && v <= n; v++) s->fase_salva[v] = (signed char)melhor[v];
+            }
+            free(partida);
+            free(melhor);
+            break;
+        }
+        default:
+            break;
+    }
+    memset(s->fase_alvo, 0, (size_t)n + 1);
+    s->tamanho_alvo = 0;
+    s->refases[tipo]++;
+}
+
+// 28ª ALTERAÇÃO: decisão do CDCL pelo grafo (DSatur), com o MapaVariaveis da fórmula.
+// livres/coloridos/uso_cor andam junto com a trilha (atribuirCDCL e voltarAoNivel); a escolha
+// do vértice percorre os vértices, o que é pouco perto da propagação de uma cor (k-1 variáveis
+// do vértice e uma por vizinho).
+
+/**
+ * Vértice sem cor com menos cores possíveis (desempate: maior grau) e, dele, a cor possível
+ * menos usada (desempate: maior atividade)
+ * @return Literal positivo da decisão ou 0 se todos os vértices têm cor
+ */
+static int decisaoGrafo(const SolverCDCL *s)
+{
+    const MapaVariaveis *m = s->vertices;
+    int melhor = -1;
+    for (int u = 0; u < m->num_vertices; u++) {
+        if (s->coloridos[u] || s->livres[u] == 0) continue;
+        if (melhor < 0 || s->livres[u] < s->livres[melhor] ||
+            (s->livres[u] == s->livres[melhor] && m->grau[u] > m->grau[melhor])) {
+            melhor = u;
+        }
+    }
+    if (melhor < 0) return 0;
+
+    int escolhida = 0;
+    const int *vars = m->variavel + (size_t)melhor * m->k;
+    for (int c = 1; c <= m->k; c++) {
+        int x = vars[c - 1];
+        if (s->valor[2 * x] != 0) continue;
+        if (escolhida == 0 || s->uso_cor[c] < s->uso_cor[m->cor[escolhida]] ||
+            (s->uso_cor[c] == s->uso_cor[m->cor[escolhida]] && s->atividade[x] > s->atividade[escolhida])) {
+            escolhida = x;
+        }
+    }
+    return 2 * escolhida;
+}
+
+static void liberarCDCL(SolverCDCL *s)
+{
+    if (s->vigias) {
+        for (int l = 0; l < 2 * (s->num_vars + 1); l++) liberarRastreado(s->vigias[l].itens);
+    }
+    liberarRastreado(s->vigias);
+    liberarRastreado(s->arena);
+    liberarRastreado(s->valor);
+    liberarRastreado(s->nivel);
+    liberarRastreado(s->razao);
+    liberarRastreado(s->trilha);
+    liberarRastreado(s->inicio_nivel);
+    liberarRastreado(s->atividade);
+    liberarRastreado(s->heap);
+    liberarRastreado(s->pos_heap);
+    liberarRastreado(s->visto);
+    liberarRastreado(s->aprendida);
+    liberarRastreado(s->pilha);
+    liberarRastreado(s->limpar);
+    liberarRastreado(s->selo_nivel);
+    liberarRastreado(s->fase_salva);
+    liberarRastreado(s->fase_alvo);
+    liberarRastreado(s->fase_melhor);
+    liberarRastreado(s->livres);
+    liberarRastreado(s->coloridos);
+    liberarRastreado(s->uso_cor);
+}
+
+/**
+ * Monta o solver a partir da fórmula: literais repetidos saem, tautologias são ignoradas e as
+ * cláusulas unitárias viram atribuições do nível 0
+ * @return 1 pronto, 0 fórmula trivialmente insatisfatível, -1 sem memória
+ */
+static int prepararCDCL(SolverCDCL *s, Formula *f)
+{
+    memset(s, 0, sizeof(*s));
+    int n = s->num_vars = f->num_literais;
+    size_t nv = (size_t)n + 2, nl = 2 * ((size_t)n + 1);
+    s->vigias = alocarRastreadoZerado(MEM_VIGIAS, nl * sizeof(ListaVigias));
+    s->valor = alocarRastreadoZerado(MEM_INTERPRETACAO, nl);
+    s->nivel = alocarRastreadoZerado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->razao = alocarRastreado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->trilha = alocarRastreado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->inicio_nivel = alocarRastreadoZerado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->atividade = alocarRastreadoZerado(MEM_INTERPRETACAO, nv * sizeof(double));
+    s->heap = alocarRastreado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->pos_heap = alocarRastreado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->visto = alocarRastreadoZerado(MEM_INTERPRETACAO, nl);
+    s->aprendida = alocarRastreado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->pilha = alocarRastreado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->limpar = alocarRastreado(MEM_INTERPRETACAO, nv * sizeof(int));
+    s->selo_nivel = alocarRastreadoZerado(MEM_INTERPRETACAO, nv * sizeof(unsigned));
+    s->fase_salva = alocarRastreado(MEM_INTERPRETACAO, nv);
+    s->fase_alvo = alocarRastreadoZerado(MEM_INTERPRETACAO, nv);
+    s->fase_melhor = alocarRastreadoZerado(MEM_INTERPRETACAO, nv);
+    s->cap_arena = 1024;
+    s->arena = alocarRastreado(MEM_CLAUSULAS, s->cap_arena * sizeof(int));
+    if (!s->vigias || !s->valor || !s->nivel || !s->razao || !s->trilha || !s->inicio_nivel || !s->atividade ||
+        !s->heap || !s->pos_heap || !s->visto || !s->aprendida || !s->pilha || !s->limpar || !s->selo_nivel ||
+        !s->fase_salva || !s->fase_alvo || !s->fase_melhor || !s->arena) {
+        return -1;
+    }
+    s->politica = politicaPolaridade();
+    memset(s->fase_salva, -1, nv);  // Fase original: falso
+    if (ramificarPeloGrafo(f)) {  // 28ª ALTERAÇÃO: sem memória para os contadores, fica só o VSIDS
+        const MapaVariaveis *m = f->vertices;
+        s->livres = alocarRastreado(MEM_INTERPRETACAO, ((size_t)m->num_vertices + 1) * sizeof(int));
+        s->coloridos = alocarRastreadoZerado(MEM_INTERPRETACAO, ((size_t)m->num_vertices + 1) * sizeof(int));
+        s->uso_cor = alocarRastreadoZerado(MEM_INTERPRETACAO, ((size_t)m->k + 1) * sizeof(int));
+        if (s->livres && s->coloridos && s->uso_cor) {
+            for (int u = 0; u < m->num_vertices; u++) s->livres[u] = m->k;
+            s->vertices = m;
+        }
+    }
+    s->incremento = 1.0;
+    for (int v = 1; v <= n; v++) {
+        s->razao[v] = SEM_RAZAO;
+        s->pos_heap[v] = -1;
+        heapIncluir(s, v);
+    }
+
+    // 'visto' (por literal, só aqui) marca os literais já vistos na cláusula
+    int *lits = NULL;
+    size_t cap_lits = 0;
+    int resultado = 1;
+    for (int i = 0; resultado == 1 && i < f->num_clausulas; i++) {
+        const int *c = f->clausulas[i];
+        size_t tam = 0;
+        while (c[tam] != 0) tam++;
+        if (tam > cap_lits) {
+            free(lits);
+            cap_lits = tam;
+            lits = malloc(cap_lits * sizeof(int));
+            if (!lits) {
+                resultado = -1;
+                break;
+            }
+        }
+        int m = 0;
+        bool tautologia = false;
+        for (size_t j = 0; j < tam; j++) {
+            int l = LITERAL_CDCL(c[j]);
+            if (s->visto[l ^ 1]) tautologia = true;
+            if (!s->visto[l]) {
+                s->visto[l] = 1;
+                lits[m++] = l;
+            }
+        }
+        for (int j = 0; j < m; j++) s->visto[lits[j]] = 0;
+        if (tautologia) continue;
+
+        if (m == 0) {
+            resultado = 0;
+        } else if (m == 1) {
+            if (s->valor[lits[0]] == -1) resultado = 0;
+            else if (s->valor[lits[0]] == 0) atribuirCDCL(s, lits[0], SEM_RAZAO);
+        } else if (novaClausulaCDCL(s, lits, m, 0) == SEM_RAZAO) {
+            resultado = -1;
+        }
+    }
+    free(lits);
+    return resultado;
+}
+
+/**
+ * Resolve a fórmula por CDCL (a fórmula não é alterada: as cláusulas são copiadas para a arena)
+ * @param f Fórmula
+ * @param interpretacao Saída: 1 ou -1 para cada variável, se a fórmula for satisfatível
+ * @return 1 se satisfatível, 0 se insatisfatível, -1 se a busca parou antes (limite do
+ *         controle ou falta de memória)
+ */
+int satCDCL(Formula *f, int *interpretacao)
+{
+    SolverCDCL s;
+    int preparo = prepararCDCL(&s, f);
+    int resultado = preparo == 0 ? 0 : -1;  // -1: em aberto (e fica assim se faltar memória)
+    long long conflitos_rodada = 0, conflitos_reducao = 0;
+    long long limite_rodada = REINICIO_BASE * luby(0), limite_reducao = REDUCAO_INICIAL;
+    int rodada = 0;
+    // 26ª ALTERAÇÃO: rodadas de inprocessamento (GCP_INPROCESSAMENTO=0 desliga)
+    const char *env_inprocessamento = getenv("GCP_INPROCESSAMENTO");
+    bool inprocessar = !(env_inprocessamento && strcmp(env_inprocessamento, "0") == 0);
+    long long conflitos_inprocessamento = 0, limite_inprocessamento = INPROCESSAMENTO_CONFLITOS, propagacoes_rodada = 0;
+    // 27ª ALTERAÇÃO: refaseamento da política alvo (GCP_REFASE=0 desliga)
+    const char *env_refase = getenv("GCP_REFASE");
+    bool refasear_ligado = !(env_refase && strcmp(env_refase, "0") == 0);
+    long long conflitos_refase = 0, limite_refase = REFASE_INTERVALO;
+    int num_refases = 0;
+    uint64_t estado_refase = (uint64_t)f->num_literais * 0x9E3779B97F4A7C15ULL + (uint64_t)f->num_clausulas;
+
+    while (resultado == -1 && preparo == 1) {
+        int conflito = propagarCDCL(&s);
+        if (s.falhou) break;
+        if (conflito != SEM_RAZAO) {
+            estatisticas_thread.conflitos++;
+            conflitos_nao_contados++;
+            conflitos_rodada++;
+            conflitos_reducao++;
+            conflitos_inprocessamento++;
+            RASTRO(RASTRO_CONFLITO, 0);
+            if (s.nivel_atual == 0) {
+                resultado = 0;
+                break;
+            }
+            conflitos_refase++;
+            atualizarAlvo(&s, s.inicio_nivel[s.nivel_atual]);  // 27ª ALTERAÇÃO: os níveis abaixo não tiveram conflito
+            int volta = analisarConflito(&s, conflito);
+            estatisticas_thread.retrocessos++;
+            RASTRO(RASTRO_RETROCESSO, volta);
+            voltarAoNivel(&s, volta);
+            RASTRO_PROFUNDIDADE(volta);
+            if (s.num_aprendida == 1) {
+                atribuirCDCL(&s, s.aprendida[0], SEM_RAZAO);
+            } else {
+                int c = novaClausulaCDCL(&s, s.aprendida, s.num_aprendida, calcularLBD(&s) << DESLOCAMENTO_LBD | CLAUSULA_APRENDIDA);
+                if (c == SEM_RAZAO) break;
+                s.num_aprendidas++;
+                atribuirCDCL(&s, s.aprendida[0], c);
+            }
+            s.incremento /= 0.95;  // Decaimento das atividades (VSIDS)
+            if (limiteEsgotado()) break;
+            continue;
+        }
+
+        if (conflitos_rodada >= limite_rodada || s.reduzir) {
+            atualizarAlvo(&s, s.num_trilha);
+            voltarAoNivel(&s, 0);
+            RASTRO_PROFUNDIDADE(0);
+            estatisticas_thread.reinicios++;
+            RASTRO(RASTRO_REINICIO, rodada);
+            conflitos_rodada = 0;
+            limite_rodada = REINICIO_BASE * luby(++rodada);
+            if (conflitos_reducao >= limite_reducao || s.reduzir) {
+                if (!reduzirAprendidas(&s)) break;
+                s.reduzir = false;
+                conflitos_reducao = 0;
+                limite_reducao += REDUCAO_PASSO;
+            }
+            if (inprocessar && conflitos_inprocessamento >= limite_inprocessamento) {
+                long long orcamento = (s.propagacoes - propagacoes_rodada) * ESFORCO_INPROCESSAMENTO / 100;
+                int r = inprocessarCDCL(&s, orcamento > ESFORCO_MINIMO ? orcamento : ESFORCO_MINIMO);
+                if (r == 0) resultado = 0;
+                if (r != 1) break;
+                propagacoes_rodada = s.propagacoes;
+                conflitos_inprocessamento = 0;
+                limite_inprocessamento += limite_inprocessamento / 10;
+            }
+            if (s.politica == POLARIDADE_ALVO && refasear_ligado && conflitos_refase >= limite_refase) {
+                int ciclo = num_refases++ % (int)(sizeof(ciclo_refases) / sizeof(ciclo_refases[0]));
+                refasear(&s, f, ciclo_refases[ciclo], &estado_refase);
+                conflitos_refase = 0;
+                limite_refase = (long long)REFASE_INTERVALO * (num_refases + 1);
+            }
+            continue;
+        }
+        if (limiteEsgotado()) break;
+
+        // Decisão: pelo grafo (28ª ALTERAÇÃO) ou a variável livre de maior atividade, com o valor
+        // da política de polaridade
+        int decisao = s.vertices ? decisaoGrafo(&s) : 0;
+        while (decisao == 0 && s.num_heap > 0) {
+            int candidata = heapRetirarMaior(&s);
+            if (s.valor[2 * candidata] == 0) decisao = literalDecisao(&s, candidata);
+        }
+        if (decisao == 0) {
+            resultado = 1;
+            break;
+        }
+        if (++estatisticas_thread.decisoes >= 4096) descarregarEstatisticas();
+        RASTRO(RASTRO_DECISAO, decisao >> 1);
+        s.inicio_nivel[++s.nivel_atual] = s.num_trilha;
+        RASTRO_PROFUNDIDADE(s.nivel_atual);
+        atribuirCDCL(&s, decisao, SEM_RAZAO);
+    }
+
+    if (resultado == 1) {
+        for (int v = 1; v <= s.num_vars; v++) interpretacao[v] = s.valor[2 * v] == 1 ? 1 : -1;
+    }
+    for (int t = 0; t < NUM_REFASES; t++) __atomic_fetch_add(&refases_total[t], s.refases[t], __ATOMIC_RELAXED);
+    liberarCDCL(&s);
+    RASTRO_PROFUNDIDADE(0);
+    return resultado;
+}
+
+/**
+ * Roda o solver escolhido por GCP_SAT: "dpll" é o SAT() recursivo (que preenche a árvore de
+ * decisão); sem a variável, ou com qualquer outro valor, é o satCDCL
+ * @return 1 satisfatível, 0 insatisfatível (ou limite do controle, no SAT()), -1 a busca parou
+ *         antes (limite ou falta de memória)
+ */
+int resolverFormula(Formula *f, int *interpretacao, BinaryTree *raiz)
+{
+    const char *motor = getenv("GCP_SAT");
+    if (motor && strcmp(motor, "dpll") == 0) {
+        // 28ª ALTERAÇÃO: escolha pelo grafo decidida uma vez (sem memória para o vetor, genérica)
+        uso_cor_dpll = ramificarPeloGrafo(f) ? malloc(((size_t)f->vertices->k + 1) * sizeof(int)) : NULL;
+        int resultado = SAT(f, interpretacao, raiz) ? 1 : 0;
+        free(uso_cor_dpll);
+        uso_cor_dpll = NULL;
+        return resultado;
+    }
+    return satCDCL(f, interpretacao);
+}
+
+// 8ª ALTERAÇÃO: arestas em memória dinâmica e leitura de vários formatos de grafo
+
+/**
+ * Inicializa um grafo vazio (sem arestas alocadas)
+ * @param g Grafo a inicializar
+ */
+void iniciarGrafo(Grafo *g)
+{
+    g->n_vertices = 0;
+    g->m_arestas = 0;
+    g->capacidade_arestas = 0;
+    g->arestas = NULL;
+    g->adj_inicio = NULL;
+    g->adj_vizinhos = NULL;
+    g->m_distintas = 0;
+    g->num_lacos = 0;
+    g->lacos = NULL;
+}
+
+/**
+ * Libera a lista de arestas do grafo
+ * @param g Grafo a liberar
+ */
+void liberarGrafo(Grafo *g)
+{
+    free(g->arestas);
+    free(g->adj_inicio);
+    free(g->adj_vizinhos);
+    free(g->lacos);
+    iniciarGrafo(g);
+}
+
+/**
+ * Garante espaço para pelo menos 'quantidade' arestas (cresce dobrando)
+ * @return false se faltou memória
+ */
+bool reservarArestas(Grafo *g, size_t quantidade)
+{
+    if (quantidade <= g->capacidade_arestas) return true;
+    if (quantidade > MAX_ARESTAS) return false;
+
+    size_t nova = g->capacidade_arestas ? g->capacidade_arestas : 1024;
+    while (nova < quantidade) nova *= 2;
+    if (nova > MAX_ARESTAS) nova = MAX_ARESTAS;
+
+    int (*novo)[2] = realloc(g->arestas, nova * sizeof(*novo));
+    if (!novo) return false;
+    g->arestas = novo;
+    g->capacidade_arestas = nova;
+    return true;
+}
+
+/**
+ * Acrescenta a aresta (a, b), com vértices numerados a partir de 0
+ * @return false se faltou memória ou o limite de arestas foi atingido
+ */
+bool adicionarAresta(Grafo *g, int a, int b)
+{
+    if (!reservarArestas(g, (size_t)g->m_arestas + 1)) return false;
+    g->arestas[g->m_arestas][0] = a;
+    g->arestas[g->m_arestas][1] = b;
+    g->m_arestas++;
+    return true;
+}
+
+// 9ª ALTERAÇÃO: adjacência CSR (offsets + vizinhos), ordenada e sem repetições
+/**
+ * Monta a adjacência CSR a partir da lista de arestas. Cada aresta entra nas duas direções;
+ * as listas saem ordenadas por uma ordenação por contagem em duas passadas (a segunda é a
+ * "transposta" da primeira, o que já entrega cada lista em ordem crescente), e depois as
+ * repetições (arestas duplicadas ou invertidas no arquivo) são removidas. Laços (v-v) ficam
+ * fora das listas e são guardados em g->lacos, pois impedem qualquer coloração.
+ * @param g Grafo com a lista de arestas já preenchida
+ * @return false se faltou memória
+ */
+bool construirAdjacencia(Grafo *g)
+{
+    int n = g->n_vertices;
+    free(g->adj_inicio);
+    free(g->adj_vizinhos);
+    free(g->lacos);
+    g->adj_inicio = NULL;
+    g->adj_vizinhos = NULL;
+    g->lacos = NULL;
+    g->m_distintas = 0;
+    g->num_lacos = 0;
+
+    size_t *inicio = calloc((size_t)n + 1, sizeof(size_t));
+    size_t *pos = malloc(((size_t)n + 1) * sizeof(size_t));
+    if (!inicio || !pos) {
+        free(inicio);
+        free(pos);
+        return false;
+    }
+
+    // Grau de cada vértice (sem laços)
+    size_t num_lacos = 0;
+    for (int i = 0; i < g->m_arestas; i++) {
+        int a = g->arestas[i][0], b = g->arestas[i][1];
+        if (a == b) { num_lacos++; continue; }
+        inicio[a + 1]++;
+        inicio[b + 1]++;
+    }
+    for (int v = 0; v < n; v++) inicio[v + 1] += inicio[v];
+    size_t total = inicio[n];
+
+    int *temp = malloc((total > 0 ? total : 1) * sizeof(int));
+    int *vizinhos = malloc((total > 0 ? total : 1) * sizeof(int));
+    int *lacos = num_lacos > 0 ? malloc(num_lacos * sizeof(int)) : NULL;
+    if (!temp || !vizinhos || (num_lacos > 0 && !lacos)) {
+        free(inicio);
+        free(pos);
+        free(temp);
+        free(vizinhos);
+        free(lacos);
+        return false;
+    }
+
+    // 1ª passada: listas na ordem do arquivo
+    memcpy(pos, inicio, ((size_t)n + 1) * sizeof(size_t));
+    size_t l = 0;
+    for (int i = 0; i < g->m_arestas; i++) {
+        int a = g->arestas[i][0], b = g->arestas[i][1];
+        if (a == b) { lacos[l++] = a; continue; }
+        temp[pos[a]++] = b;
+        temp[pos[b]++] = a;
+    }
+
+    // 2ª passada: percorrendo os vértices em ordem crescente, cada lista recebe seus vizinhos já ordenados
+    memcpy(pos, inicio, ((size_t)n + 1) * sizeof(size_t));
+    for (int v = 0; v < n; v++) {
+        for (size_t j = inicio[v]; j < inicio[v + 1]; j++) {
+            vizinhos[pos[temp[j]]++] = v;
+        }
+    }
+    free(temp);
+
+    // Remove repetições dentro de cada lista, compactando o vetor
+    size_t escrito = 0;
+    for (int v = 0; v < n; v++) {
+        size_t ini = inicio[v], fim = inicio[v + 1];
+        inicio[v] = escrito;
+        for (size_t j = ini; j < fim; j++) {
+            if (escrito > inicio[v] && vizinhos[escrito - 1] == vizinhos[j]) continue;
+            vizinhos[escrito++] = vizinhos[j];
+        }
+    }
+    inicio[n] = escrito;
+    free(pos);
+
+    int *encolhido = realloc(vizinhos, (escrito > 0 ? escrito : 1) * sizeof(int));
+    if (encolhido) vizinhos = encolhido;
+
+    // Laços: ordena (são poucos) e remove repetições
+    for (size_t i = 1; i < num_lacos; i++) {
+        int x = lacos[i];
+        size_t j = i;
+        while (j > 0 && lacos[j - 1] > x) { lacos[j] = lacos[j - 1]; j--; }
+        lacos[j] = x;
+    }
+    size_t lacos_distintos = 0;
+    for (size_t i = 0; i < num_lacos; i++) {
+        if (lacos_distintos == 0 || lacos[lacos_distintos - 1] != lacos[i]) lacos[lacos_distintos++] = lacos[i];
+    }
+
+    g->adj_inicio = inicio;
+    g->adj_vizinhos = vizinhos;
+    g->m_distintas = (int)(escrito / 2);
+    g->lacos = lacos;
+    g->num_lacos = (int)lacos_distintos;
+
+    if ((size_t)g->m_distintas + num_lacos != (size_t)g->m_arestas) {
+        fprintf(stderr, "Aviso: %d arestas repetidas ou invertidas foram ignoradas.\n",
+                g->m_arestas - g->m_distintas - (int)num_lacos);
+    }
+    if (g->num_lacos > 0) {
+        fprintf(stderr, "Aviso: o vértice %d tem laço (aresta com ele mesmo); nenhuma coloração é possível.\n",
+                g->lacos[0] + 1);
+    }
+    return true;
+}
+
+/**
+ * Grau (número de vizinhos distintos) de um vértice, pela adjacência CSR
+ */
+static inline int grauVertice(const Grafo *g, int v)
+{
+    return (int)(g->adj_inicio[v + 1] - g->adj_inicio[v]);
+}
+
+// Lê um inteiro não negativo a partir de *p, pulando espaços; devolve false se não houver número
+static bool lerNumeroLinha(char **p, long long *valor)
+{
+    char *q = *p;
+    while (*q == ' ' || *q == '\t' || *q == '\r') q++;
+    if (*q < '0' || *q > '9') return false;
+
+    long long v = 0;
+    while (*q >= '0' && *q <= '9') {
+        if (v <= INT_MAX) v = v * 10 + (*q - '0');  // Acima disso já é inválido
+        q++;
+    }
+    *p = q;
+    *valor = v;
+    return true;
+}
+
+// Só sobrou espaço em branco na linha?
+static bool restoVazio(const char *p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return *p == '\0';
+}
+
+/**
+ * Lê um grafo de arquivo, linha a linha (sem limite de tamanho). Formatos aceitos:
+ *  - formato do projeto: nº de vértices, nº de arestas, linha com '*', e depois "u v" (vértices a partir de 0)
+ *  - DIMACS .col: linhas 'c' de comentário, "p edge n m" e "e u v" (vértices a partir de 1)
+ *  - lista de arestas: só linhas "u v" (vértices a partir de 0; n = maior vértice + 1)
+ * Todo vértice é validado; a lista de arestas cresce conforme a leitura.
+ * @param nome_arquivo Arquivo de entrada
+ * @param g Grafo de saída (as arestas são alocadas aqui; liberar com liberarGrafo)
+ * @return true se a leitura foi bem-sucedida
+ */
+bool lerGrafo(const char *nome_arquivo, Grafo *g) { // 3ª ALTERAÇÃO: função lerGrafo
+    iniciarGrafo(g);
+    double inicio = iniciarFase(FASE_LER_GRAFO);  // 17ª ALTERAÇÃO
+
+    FILE *fp = fopen(nome_arquivo, "r");
+    if (!fp) {
+        perror(nome_arquivo);
+        return false;
+    }
+    setvbuf(fp, NULL, _IOFBF, 1 << 20);  // Buffer grande: arquivos de grafo podem ter centenas de MB
+
+    enum { DESCONHECIDO, PROJETO, DIMACS, LISTA } formato = DESCONHECIDO;
+    long long m_declarado = -1;   // Nº de arestas anunciado no arquivo (-1 se não houver)
+    int base = 0;                 // Número do primeiro vértice no arquivo (0 ou 1)
+    int maior_vertice = -1;       // Para a lista de arestas, que não informa n
+    bool ok = true;
+    bool separador_lido = false;  // Formato do projeto: já passou pela linha '*'
+
+    char *linha = NULL;
+    size_t tam_linha = 0;
+    long long num_linha = 0;
+
+    while (ok && getline(&linha, &tam_linha, fp) != -1) {
+        num_linha++;
+        char *p = linha;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '\n' || *p == '\r' || *p == '\0') continue;  // Linha em branco
+
+        if (*p == 'c' && formato != PROJETO) continue;         // Comentário DIMACS
+
+        if (*p == 'p' && formato == DESCONHECIDO) {            // Cabeçalho DIMACS
+            long long n, m;
+            if (sscanf(p, "p %*s %lld %lld", &n, &m) != 2 || n < 0 || n > INT_MAX || m < 0) {
+                printf("Erro na linha %lld: cabeçalho 'p edge n m' inválido.\n", num_linha);
+                ok = false;
+                break;
+            }
+            formato = DIMACS;
+            base = 1;
+            g->n_vertices = (int)n;
+            m_declarado = m;
+            if ((size_t)m <= MAX_ARESTAS) reservarArestas(g, (size_t)m);
+            continue;
+        }
+
+        if (*p == '*') {                                       // Separador do formato do projeto
+            if (formato != PROJETO || separador_lido) {
+                printf("Erro na linha %lld: '*' inesperado.\n", num_linha);
+                ok = false;
+            }
+            separador_lido = true;
+            continue;
+        }
+
+        if (*p == 'e') {                                       // Aresta DIMACS
+            if (formato != DIMACS) {
+                printf("Erro na linha %lld: aresta 'e' antes do cabeçalho 'p edge'.\n", num_linha);
+                ok = false;
+                break;
+            }
+            p++;
+        }
+
+        long long a, b;
+        bool tem_a = lerNumeroLinha(&p, &a);
+        bool tem_b = tem_a && lerNumeroLinha(&p, &b);
+
+        if (formato == DESCONHECIDO) {
+            if (tem_a && !tem_b && restoVazio(p)) {
+                // Formato do projeto: esta linha é o nº de vértices, a próxima o nº de arestas
+                formato = PROJETO;
+                if (a > INT_MAX) {
+                    printf("Erro ao ler número de vértices.\n");
+                    ok = false;
+                    break;
+                }
+                g->n_vertices = (int)a;
+                continue;
+            }
+            formato = LISTA;
+        }
+
+        if (formato == PROJETO && m_declarado < 0) {
+            if (!tem_a || tem_b || !restoVazio(p)) {
+                printf("Erro ao ler número de arestas.\n");
+                ok = false;
+                break;
+            }
+            m_declarado = a;
+            if ((size_t)a <= MAX_ARESTAS) reservarArestas(g, (size_t)a);
+            continue;
+        }
+
+        if (!tem_b || !restoVazio(p)) {
+            printf("Erro na linha %lld: aresta mal formada.\n", num_linha);
+            ok = false;
+            break;
+        }
+
+        // Validação dos vértices
+        a -= base;
+        b -= base;
+        if (a < 0 || b < 0 || a > INT_MAX || b > INT_MAX ||
+            (formato != LISTA && (a >= g->n_vertices || b >= g->n_vertices))) {
+            printf("Erro na linha %lld: vértice fora do intervalo (%d a %d).\n",
+                   num_linha, base, (formato == LISTA ? INT_MAX : g->n_vertices - 1 + base));
+            ok = false;
+            break;
+        }
+        if (formato == LISTA) {
+            if (a > maior_vertice) maior_vertice = (int)a;
+            if (b > maior_vertice) maior_vertice = (int)b;
+        }
+
+        if (!adicionarAresta(g, (int)a, (int)b)) {
+            printf("Erro: memória insuficiente ou mais de %lld arestas (linha %lld).\n", (long long)MAX_ARESTAS, num_linha);
+            ok = false;
+        }
+    }
+
+    free(linha);
+    fclose(fp);
+
+    if (ok && formato == LISTA) g->n_vertices = maior_vertice + 1;
+    if (ok && formato == PROJETO && g->m_arestas < m_declarado) {
+        printf("Erro ao ler aresta %d.\n", g->m_arestas + 1);
+        ok = false;
+    }
+    if (ok && m_declarado >= 0 && g->m_arestas != m_declarado) {
+        fprintf(stderr, "Aviso: o arquivo anuncia %lld arestas, mas foram lidas %d.\n", m_declarado, g->m_arestas);
+    }
+    if (ok && formato == DESCONHECIDO) {
+        printf("Erro: arquivo de grafo vazio.\n");
+        ok = false;
+    }
+
+    if (ok && !construirAdjacencia(g)) {
+        printf("Erro: memória insuficiente para montar a adjacência.\n");
+        ok = false;
+    }
+
+    if (!ok) liberarGrafo(g);
+    registrarFase(FASE_LER_GRAFO, inicio);
+    return ok;
+}
+
+bool salvarCNFBinario(Grafo *g, int k, const char *nome_arquivo);
+
+void gerarCNF(Grafo *g, int k, const char *nome_arquivo) {
+    // 7ª ALTERAÇÃO: arquivos terminados em .bcnf são gravados no formato binário
+    size_t tam_nome = strlen(nome_arquivo);
+    if (tam_nome > 5 && strcmp(nome_arquivo + tam_nome - 5, ".bcnf") == 0) {
+        salvarCNFBinario(g, k, nome_arquivo);
+        return;
+    }
+
     FILE *f = fopen(nome_arquivo, "w");
     if (!f) {
-        perror("Erro ao criar arquivo CNF");
+        perror("Erro ao criar arquivo CNF");
+        return;
+    }
+
+    int n = g->n_vertices;
+    int m = g->m_distintas + g->num_lacos;  // 9ª ALTERAÇÃO: uma vez por aresta distinta
+
+    int num_vars = n * k;
+    int num_clauses = 0;
+
+    // Estimativa das cláusulas (n precisa ser exata, mas ajuda)
+    num_clauses += n;                       // Regra 1: pelo menos uma cor
+    num_clauses += n * (k * (k - 1)) / 2;   // Regra 2: no máximo uma cor
+    num_clauses += m * k;                  // Regra 3: adjacentes
+
+    fprintf(f, "p cnf %d %d\n", num_vars, num_clauses);
+
+    // === Regra 1: cada vértice com pelo menos uma cor ===
+    for (int v = 1; v <= n; v++) {          // Para cada vértice do grafo
+        for (int c = 1; c <= k; c++) {      // Para cada cor possível
+            int var = (v - 1) * k + c;      // Calcula o índice da variável (v-1)*k + c → mapeia vértice + cor para literal
+            fprintf(f, "%d ", var);         // Escreve o literal correspondente (positivo) → quer dizer: "v tem cor c"
+        }
+        fprintf(f, "0\n");                  // Termina a cláusula com 0 (requisito do formato DIMACS)
+    }
+
+
+    // === Regra 2: vértice não pode ter 2 cores ao mesmo tempo ===
+    for (int v = 1; v <= n; v++) {                    // Para cada vértice
+        for (int c1 = 1; c1 <= k; c1++) {             // Para cada cor
+            for (int c2 = c1 + 1; c2 <= k; c2++) {    // Compara com todas as cores seguintes (evita repetição)
+                int var1 = (v - 1) * k + c1;          // Literal para vértice v com cor c1
+                int var2 = (v - 1) * k + c2;          // Literal para vértice v com cor c2
+                fprintf(f, "-%d -%d 0\n", var1, var2); // Escreve cláusula de exclusão: "-var1 ou -var2"
+            }
+        }
+    }
+
+
+    // === Regra 3: vértices adjacentes não podem ter mesma cor ===
+    // 9ª ALTERAÇÃO: percorre a adjacência CSR, cada aresta distinta uma única vez (u < v)
+    for (int u = 1; u <= n; u++) {                    // Para cada vértice do grafo
+        for (size_t j = g->adj_inicio[u - 1]; j < g->adj_inicio[u]; j++) {
+            int v = g->adj_vizinhos[j] + 1;           // Vizinho (ajustando de 0 para 1)
+            if (v < u) continue;                      // A aresta já saiu pelo outro vértice
+
+            for (int c = 1; c <= k; c++) {            // Para cada cor
+                int var_u = (u - 1) * k + c;          // Literal que diz: "u tem cor c"
+                int var_v = (v - 1) * k + c;          // Literal que diz: "v tem cor c"
+                fprintf(f, "-%d -%d 0\n", var_u, var_v);  // Cláusula dizendo que os dois **não podem** ter a mesma cor
+            }
+        }
+    }
+    for (int i = 0; i < g->num_lacos; i++) {          // Vértice com laço: nenhuma cor serve
+        int u = g->lacos[i] + 1;
+        for (int c = 1; c <= k; c++) {
+            fprintf(f, "-%d -%d 0\n", (u - 1) * k + c, (u - 1) * k + c);
+        }
+    }
+
+
+    fclose(f);
+}
+
+
+// 28ª ALTERAÇÃO: mapa das variáveis da fórmula do grafo, com os graus da adjacência CSR
+MapaVariaveis *mapearVariaveis(Grafo *g, int k)
+{
+    MapaVariaveis *m = criarMapaVariaveis(g->n_vertices, k);
+    for (int u = 0; m && u < g->n_vertices; u++) m->grau[u] = (int)(g->adj_inicio[u + 1] - g->adj_inicio[u]);
+    return m;
+}
+
+// 6ª ALTERAÇÃO: construção da fórmula direto na memória
+/**
+ * Monta a fórmula CNF da k-coloração do grafo direto na memória, sem passar pelo sat.cnf.
+ * Gera exatamente as mesmas cláusulas (e na mesma ordem) que gerarCNF escreve no arquivo,
+ * mas guarda todos os literais em um único bloco (arena), evitando formatar e reler texto.
+ * @param g Grafo a ser colorido
+ * @param k Quantidade de cores
+ * @return Ponteiro para a fórmula montada ou NULL em caso de erro
+ */
+Formula* construirFormula(Grafo *g, int k)
+{
+    int n = g->n_vertices;
+    int m = g->m_distintas + g->num_lacos;  // 9ª ALTERAÇÃO: arestas distintas da adjacência CSR
+
+    // Contagem exata (em long long para detectar estouro antes de alocar)
+    long long regra2 = (long long)n * k * (k - 1) / 2;   // Pares de cores por vértice
+    long long regra3 = (long long)m * k;                 // Uma cláusula por aresta e cor
+    long long num_vars = (long long)n * k;
+    long long num_clauses = n + regra2 + regra3;
+    long long tam_arena = (long long)n * (k + 1) + 3 * (regra2 + regra3);  // Literais + terminadores 0
+
+    if (num_vars > INT_MAX || num_clauses > INT_MAX || tam_arena > INT_MAX) {
+        printf("Erro: fórmula grande demais para %d vértices e K = %d.\n", n, k);
+        return NULL;
+    }
+
+    Formula *f = malloc(sizeof(Formula));
+    if (!f) return NULL;
+    f->num_literais = (int)num_vars;
+    f->num_clausulas = (int)num_clauses;
+    f->clausulas = alocarRastreado(MEM_CLAUSULAS, (size_t)(num_clauses > 0 ? num_clauses : 1) * sizeof(int*));
+    f->arena = f->clausulas ? alocarRastreado(MEM_CLAUSULAS, (size_t)(tam_arena > 0 ? tam_arena : 1) * sizeof(int)) : NULL;
+    f->mapa = NULL;
+    f->tam_mapa = 0;
+    f->vertices = NULL;
+    if (!f->clausulas || !f->arena) {
+        liberarRastreado(f->clausulas);
+        liberarRastreado(f->arena);
+        free(f);
+        printf("Erro ao alocar a fórmula em memória.\n");
+        return NULL;
+    }
+
+    int *p = f->arena;   // Próxima posição livre da arena
+    int c_atual = 0;     // Próxima cláusula a preencher
+
+    // === Regra 1: cada vértice com pelo menos uma cor ===
+    for (int v = 1; v <= n; v++) {
+        f->clausulas[c_atual++] = p;
+        for (int c = 1; c <= k; c++) {
+            *p++ = (v - 1) * k + c;
+        }
+        *p++ = 0;
+    }
+
+    // === Regra 2: vértice não pode ter 2 cores ao mesmo tempo ===
+    for (int v = 1; v <= n; v++) {
+        for (int c1 = 1; c1 <= k; c1++) {
+            for (int c2 = c1 + 1; c2 <= k; c2++) {
+                f->clausulas[c_atual++] = p;
+                *p++ = -((v - 1) * k + c1);
+                *p++ = -((v - 1) * k + c2);
+                *p++ = 0;
+            }
+        }
+    }
+
+    // === Regra 3: vértices adjacentes não podem ter mesma cor ===
+    for (int u = 1; u <= n; u++) {
+        for (size_t j = g->adj_inicio[u - 1]; j < g->adj_inicio[u]; j++) {
+            int v = g->adj_vizinhos[j] + 1;
+            if (v < u) continue;  // Cada aresta distinta uma vez só
+
+            for (int c = 1; c <= k; c++) {
+                f->clausulas[c_atual++] = p;
+                *p++ = -((u - 1) * k + c);
+                *p++ = -((v - 1) * k + c);
+                *p++ = 0;
+            }
+        }
+    }
+    for (int i = 0; i < g->num_lacos; i++) {  // Laço: "u não tem cor c" para toda cor
+        int u = g->lacos[i] + 1;
+        for (int c = 1; c <= k; c++) {
+            f->clausulas[c_atual++] = p;
+            *p++ = -((u - 1) * k + c);
+            *p++ = -((u - 1) * k + c);
+            *p++ = 0;
+        }
+    }
+
+    f->vertices = mapearVariaveis(g, k);  // 28ª ALTERAÇÃO
+    return f;
+}
+
+
+// 7ª ALTERAÇÃO: formato binário de CNF (cache de fórmulas já geradas)
+//
+// Layout do arquivo .bcnf (inteiros na ordem de bytes nativa da máquina que gravou):
+//   [CabecalhoCNFBinario: 64 bytes][dados]
+// A arena bruta só pode ser mapeada sem conversão na mesma ordem de bytes, então o arquivo é um
+// cache local: marca_ordem guarda ORDEM_CNF_BINARIO como foi gravado e o leitor recusa (e o
+// cache regenera) arquivos vindos de uma máquina com a ordem trocada.
+// Codificação CNF_BRUTA: os dados são a própria arena (int32 com os 0 terminadores), então o
+// arquivo é mapeado com mmap e as cláusulas apontam direto para dentro dele, sem cópia.
+// Codificação CNF_COMPACTA: para cada cláusula, o tamanho e depois cada literal como a diferença
+// para o anterior (zigzag + varint). Ocupa bem menos disco, mas precisa ser decodificada.
+// Escolhida com GCP_CNF_COMPACTA=1 (vale para o cache GCP_CACHE_CNF e para gerarCNF em .bcnf).
+#define MAGICA_CNF_BINARIO "GCPBCNF"
+#define VERSAO_CNF_BINARIO 2          // 2: marca de ordem dos bytes no lugar do campo reservado
+#define ORDEM_CNF_BINARIO 0x01020304u
+enum { CNF_BRUTA = 0, CNF_COMPACTA = 1 };
+
+typedef struct {
+    char magica[8];            // "GCPBCNF\0"
+    uint32_t versao;           // VERSAO_CNF_BINARIO
+    uint32_t codificacao;      // CNF_BRUTA ou CNF_COMPACTA
+    uint32_t num_literais;     // Quantidade de variáveis
+    uint32_t num_clausulas;    // Quantidade de cláusulas
+    uint64_t tam_arena;        // Inteiros na arena (literais + terminadores)
+    uint64_t tam_dados;        // Bytes de dados depois do cabeçalho
+    uint64_t hash_grafo;       // Identifica o grafo de origem (0 se desconhecido)
+    uint32_t k;                // Quantidade de cores usada na geração
+    uint32_t marca_ordem;      // ORDEM_CNF_BINARIO na ordem nativa de quem gravou
+    uint64_t checksum;         // Soma de verificação dos dados
+} CabecalhoCNFBinario;
+
+/**
+ * Soma de verificação rápida (8 bytes por vez, estilo FNV com mistura multiplicativa)
+ * @param dados Bytes a verificar
+ * @param tam Quantidade de bytes
+ * @return Valor de 64 bits que muda com qualquer alteração nos dados
+ */
+uint64_t checksumDados(const void *dados, size_t tam)
+{
+    const unsigned char *p = dados;
+    uint64_t h = 0xcbf29ce484222325ULL ^ tam;
+    size_t i = 0;
+    for (; i + 8 <= tam; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0x100000001b3ULL;
+        h ^= h >> 29;
+    }
+    for (; i < tam; i++) h = (h ^ p[i]) * 0x100000001b3ULL;
+    return h;
+}
+
+/**
+ * Identificador do grafo (número de vértices, arestas e a lista de arestas)
+ * @param g Grafo
+ * @return Hash de 64 bits do grafo
+ */
+uint64_t hashGrafo(Grafo *g)
+{
+    uint64_t h = checksumDados(g->arestas, (size_t)g->m_arestas * 2 * sizeof(int));
+    h ^= ((uint64_t)g->n_vertices << 32) | (uint32_t)g->m_arestas;
+    return h * 0x9e3779b97f4a7c15ULL;
+}
+
+// Escreve um inteiro sem sinal em varint (7 bits por byte); devolve quantos bytes usou
+static size_t escreverVarint(unsigned char *p, uint32_t x)
+{
+    size_t n = 0;
+    while (x >= 0x80) {
+        p[n++] = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    p[n++] = (unsigned char)x;
+    return n;
+}
+
+// Lê um varint; devolve NULL se passar do fim do buffer
+static const unsigned char *lerVarint(const unsigned char *p, const unsigned char *fim, uint32_t *x)
+{
+    uint32_t v = 0;
+    for (int desloc = 0; p < fim && desloc < 35; desloc += 7) {
+        unsigned char b = *p++;
+        v |= (uint32_t)(b & 0x7f) << desloc;
+        if (!(b & 0x80)) {
+            *x = v;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Salva uma fórmula no formato binário
+ * @param f Fórmula (precisa estar em arena, como as de construirFormula)
+ * @param nome_arquivo Arquivo de saída
+ * @param hash_grafo Identificação do grafo de origem (0 se não houver)
+ * @param k Quantidade de cores (0 se não se aplica)
+ * @param codificacao CNF_BRUTA (recarga instantânea) ou CNF_COMPACTA (arquivo menor)
+ * @return true se o arquivo foi escrito
+ */
+bool salvarFormulaBinaria(Formula *f, const char *nome_arquivo, uint64_t hash_grafo, int k, int codificacao)
+{
+    // Tamanho da arena: do começo da primeira cláusula até o 0 da última
+    size_t tam_arena = 0;
+    if (f->num_clausulas > 0) {
+        int *ultima = f->clausulas[f->num_clausulas - 1];
+        while (*ultima != 0) ultima++;
+        tam_arena = (size_t)(ultima - f->clausulas[0]) + 1;
+    }
+
+    unsigned char *dados;
+    size_t tam_dados;
+    if (codificacao == CNF_BRUTA) {
+        dados = (unsigned char *)f->clausulas[0];
+        tam_dados = tam_arena * sizeof(int);
+    } else {
+        dados = malloc(tam_arena * 5 + 5 * (size_t)f->num_clausulas + 1);  // Pior caso: 5 bytes por número
+        if (!dados) return false;
+        tam_dados = 0;
+        for (int i = 0; i < f->num_clausulas; i++) {
+            int *c = f->clausulas[i];
+            uint32_t tam = 0;
+            while (c[tam] != 0) tam++;
+            tam_dados += escreverVarint(dados + tam_dados, tam);
+            int anterior = 0;
+            for (uint32_t j = 0; j < tam; j++) {
+                int32_t delta = c[j] - anterior;
+                tam_dados += escreverVarint(dados + tam_dados, ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));  // zigzag
+                anterior = c[j];
+            }
+        }
+    }
+
+    CabecalhoCNFBinario cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_CNF_BINARIO, sizeof(MAGICA_CNF_BINARIO));
+    cab.versao = VERSAO_CNF_BINARIO;
+    cab.codificacao = (uint32_t)codificacao;
+    cab.num_literais = (uint32_t)f->num_literais;
+    cab.num_clausulas = (uint32_t)f->num_clausulas;
+    cab.tam_arena = tam_arena;
+    cab.tam_dados = tam_dados;
+    cab.hash_grafo = hash_grafo;
+    cab.k = (uint32_t)k;
+    cab.marca_ordem = ORDEM_CNF_BINARIO;
+    cab.checksum = checksumDados(dados, tam_dados);
+
+    // Escreve em um temporário e renomeia: quem ler nunca vê um arquivo pela metade
+    static unsigned contador_temporarios = 0;  // Nome único também entre threads do mesmo processo
+    char temporario[4096];
+    snprintf(temporario, sizeof(temporario), "%s.%d.%u.tmp", nome_arquivo, (int)getpid(),
+             __atomic_fetch_add(&contador_temporarios, 1, __ATOMIC_RELAXED));
+    FILE *fp = fopen(temporario, "wb");
+    bool ok = fp != NULL;
+    if (ok) ok = fwrite(&cab, sizeof(cab), 1, fp) == 1;
+    if (ok && tam_dados > 0) ok = fwrite(dados, 1, tam_dados, fp) == tam_dados;
+    if (fp && fclose(fp) != 0) ok = false;
+    if (ok) ok = rename(temporario, nome_arquivo) == 0;
+    if (!ok) {
+        perror("Erro ao gravar CNF binário");
+        remove(temporario);
+    }
+
+    if (codificacao != CNF_BRUTA) free(dados);
+    return ok;
+}
+
+/**
+ * Carrega uma fórmula do formato binário. Na codificação bruta, a arena é o próprio arquivo
+ * mapeado na memória (nenhuma cópia dos literais).
+ * @param nome_arquivo Arquivo .bcnf
+ * @param g Se não for NULL, confere se o arquivo foi gerado para este grafo
+ * @param k Quantidade de cores esperada (usado junto com g)
+ * @return Ponteiro para a fórmula ou NULL se o arquivo não existe, é de outro grafo ou está corrompido
+ */
+Formula* carregarFormulaBinaria(const char *nome_arquivo, Grafo *g, int k)
+{
+    int fd = open(nome_arquivo, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CabecalhoCNFBinario)) {
+        close(fd);
+        return NULL;
+    }
+    size_t tam_mapa = (size_t)st.st_size;
+    void *mapa = mmap(NULL, tam_mapa, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // O mapeamento continua válido depois de fechar o arquivo
+    if (mapa == MAP_FAILED) return NULL;
+
+    CabecalhoCNFBinario cab;
+    memcpy(&cab, mapa, sizeof(cab));
+    const unsigned char *dados = (const unsigned char *)mapa + sizeof(cab);
+
+    bool ok = memcmp(cab.magica, MAGICA_CNF_BINARIO, sizeof(MAGICA_CNF_BINARIO)) == 0
+           && cab.versao == VERSAO_CNF_BINARIO
+           && cab.marca_ordem == ORDEM_CNF_BINARIO  // Outra ordem de bytes: não dá para mapear
+           && (cab.codificacao == CNF_BRUTA || cab.codificacao == CNF_COMPACTA)
+           && cab.tam_dados == tam_mapa - sizeof(cab)
+           && cab.num_literais <= INT_MAX && cab.num_clausulas <= INT_MAX && cab.tam_arena <= INT_MAX
+           && (cab.codificacao != CNF_BRUTA || cab.tam_dados == cab.tam_arena * sizeof(int));
+    if (ok && g) ok = cab.hash_grafo == hashGrafo(g) && cab.k == (uint32_t)k;
+    if (ok) ok = cab.checksum == checksumDados(dados, cab.tam_dados);
+    if (!ok) {
+        munmap(mapa, tam_mapa);
+        return NULL;
+    }
+
+    Formula *f = malloc(sizeof(Formula));
+    int **clausulas = alocarRastreado(MEM_CLAUSULAS, (cab.num_clausulas > 0 ? cab.num_clausulas : 1) * sizeof(int*));
+    int *arena = NULL;
+    if (f && clausulas && cab.codificacao == CNF_COMPACTA) {
+        arena = alocarRastreado(MEM_CLAUSULAS, (cab.tam_arena > 0 ? cab.tam_arena : 1) * sizeof(int));
+    }
+    if (!f || !clausulas || (cab.codificacao == CNF_COMPACTA && !arena)) {
+        free(f);
+        liberarRastreado(clausulas);
+        liberarRastreado(arena);
+        munmap(mapa, tam_mapa);
+        return NULL;
+    }
+
+    uint32_t c_atual = 0;
+    if (cab.codificacao == CNF_BRUTA) {
+        // Zero cópias: as cláusulas apontam para dentro do arquivo mapeado
+        int *base = (int *)dados;
+        size_t ini = 0;
+        for (size_t i = 0; i < cab.tam_arena && c_atual < cab.num_clausulas; i++) {
+            if (base[i] == 0) {
+                clausulas[c_atual++] = base + ini;
+                ini = i + 1;
+            }
+        }
+        ok = c_atual == cab.num_clausulas;
+    } else {
+        const unsigned char *p = dados, *fim = dados + cab.tam_dados;
+        size_t pos = 0;
+        for (c_atual = 0; ok && c_atual < cab.num_clausulas; c_atual++) {
+            uint32_t tam;
+            p = lerVarint(p, fim, &tam);
+            if (!p || pos + tam + 1 > cab.tam_arena) { ok = false; break; }
+            clausulas[c_atual] = arena + pos;
+            int anterior = 0;
+            for (uint32_t j = 0; j < tam; j++) {
+                uint32_t z;
+                p = lerVarint(p, fim, &z);
+                if (!p) { ok = false; break; }
+                anterior += (int32_t)((z >> 1) ^ -(z & 1));  // Desfaz o zigzag
+                arena[pos++] = anterior;
+            }
+            arena[pos++] = 0;
+        }
+        munmap(mapa, tam_mapa);  // Tudo já foi decodificado para a arena
+        mapa = NULL;
+    }
+
+    if (!ok) {
+        free(f);
+        liberarRastreado(clausulas);
+        liberarRastreado(arena);
+        if (mapa) munmap(mapa, tam_mapa);
+        return NULL;
+    }
+
+    f->clausulas = clausulas;
+    f->num_clausulas = (int)cab.num_clausulas;
+    f->num_literais = (int)cab.num_literais;
+    f->arena = arena;
+    f->mapa = mapa;
+    f->tam_mapa = mapa ? tam_mapa : 0;
+    f->vertices = NULL;  // 28ª ALTERAÇÃO: obterFormula anexa o mapa (o arquivo não guarda o grafo)
+    return f;
+}
+
+/**
+ * Codificação dos arquivos .bcnf gravados pelo programa (GCP_CNF_COMPACTA=1 escolhe a compacta)
+ * @return CNF_BRUTA ou CNF_COMPACTA
+ */
+static int codificacaoCNFBinario(void)
+{
+    const char *env = getenv("GCP_CNF_COMPACTA");
+    return env && atoi(env) > 0 ? CNF_COMPACTA : CNF_BRUTA;
+}
+
+/**
+ * Devolve a fórmula da k-coloração, reaproveitando o cache binário quando existir.
+ * O cache é ligado pela variável de ambiente GCP_CACHE_CNF (diretório dos arquivos .bcnf).
+ * @param g Grafo
+ * @param k Quantidade de cores
+ * @return Ponteiro para a fórmula ou NULL em caso de erro
+ */
+Formula* obterFormula(Grafo *g, int k)
+{
+    const char *dir_cache = getenv("GCP_CACHE_CNF");
+    if (!dir_cache || !*dir_cache) return construirFormula(g, k);
+
+    char nome[4096];
+    uint64_t hash = hashGrafo(g);
+    snprintf(nome, sizeof(nome), "%s/%016llx_k%d.bcnf", dir_cache, (unsigned long long)hash, k);
+
+    Formula *f = carregarFormulaBinaria(nome, g, k);
+    if (f) {
+        f->vertices = mapearVariaveis(g, k);  // 28ª ALTERAÇÃO
+        return f;
+    }
+
+    f = construirFormula(g, k);
+    if (f) salvarFormulaBinaria(f, nome, hash, k, codificacaoCNFBinario());
+    return f;
+}
+
+/**
+ * Gera a fórmula da k-coloração e grava no formato binário (usado por gerarCNF para .bcnf)
+ * @param g Grafo
+ * @param k Quantidade de cores
+ * @param nome_arquivo Arquivo de saída
+ * @return true se o arquivo foi escrito
+ */
+bool salvarCNFBinario(Grafo *g, int k, const char *nome_arquivo)
+{
+    Formula *f = construirFormula(g, k);
+    if (!f) return false;
+    bool ok = salvarFormulaBinaria(f, nome_arquivo, hashGrafo(g), k, codificacaoCNFBinario());
+    liberar_formula(f);
+    return ok;
+}
+
+
+// 10ª ALTERAÇÃO: resolução de um K isolada em funções e redução k-core antes do CNF
+
+bool mostrar_detalhes = true;  // Mensagens das etapas internas (11ª ALTERAÇÃO: desligadas quando há várias threads)
+
+/**
+ * Resolve a k-coloração do grafo pelo SAT: monta a fórmula, roda o solver e decodifica as cores
+ * @param g Grafo
+ * @param k Quantidade de cores
+ * @param cores Saída: cores[v] em 1..k para cada vértice v (numerado a partir de 0)
+ * @return 1 se colorível, 0 se não, -1 em caso de erro ou prazo esgotado
+ */
+int colorirSAT(Grafo *g, int k, int *cores)
+{
+    // Monta a fórmula CNF do K direto na memória (ou do cache binário)
+    double inicio_cnf = iniciarFase(FASE_GERAR_CNF);
+    Formula *f = obterFormula(g, k);
+    registrarFase(FASE_GERAR_CNF, inicio_cnf);
+    if (!f) return -1;
+
+    // Vetor de interpretação (+1 pois não usamos o índice 0)
+    int *interpretacao = alocarRastreadoZerado(MEM_INTERPRETACAO, ((size_t)f->num_literais + 1) * sizeof(int));
+    BinaryTree *raiz = alocarRastreado(MEM_ARVORE, sizeof(BinaryTree));
+    if (!interpretacao || !raiz) {
+        liberarRastreado(interpretacao);
+        liberarRastreado(raiz);
+        liberar_formula(f);
+        printf("Erro ao alocar vetor de interpretação ou árvore.\n");
+        return -1;
+    }
+    raiz->variavel = 0;
+    raiz->valor = 0;
+    raiz->esquerda = raiz->direita = NULL;
+
+    // 21ª ALTERAÇÃO: GCP_BUSCA_LOCAL=passos tenta antes a busca local em lote (só acha soluções)
+    const char *busca_local = getenv("GCP_BUSCA_LOCAL");
+    long long passos_busca = busca_local ? atoll(busca_local) : 0;
+
+    double inicio = iniciarFase(FASE_SAT);
+    RASTRO(RASTRO_INICIO_SAT, f->num_literais);
+    int resultado;
+    if (passos_busca > 0 && buscaLocalLote(f, passos_busca, (uint64_t)k, interpretacao)) {
+        resultado = 1;
+        if (mostrar_detalhes) printf("Busca local em lote encontrou uma %d-coloração.\n", k);
+    } else {
+        resultado = resolverFormula(f, interpretacao, raiz);  // 25ª ALTERAÇÃO: CDCL, ou DPLL com GCP_SAT=dpll
+    }
+    registrarFase(FASE_SAT, inicio);
+    descarregarEstatisticas();
+    if (resultado == 0 && controle_atual && __atomic_load_n(&controle_atual->esgotado, __ATOMIC_RELAXED)) {
+        resultado = -1;  // 14ª ALTERAÇÃO: um limite acabou (19ª: inclusive o teto de memória), não é prova de UNSAT
+    }
+    RASTRO(RASTRO_FIM_SAT, resultado);
+
+    // A cor de cada vértice é a variável (v-1)*k + cor que ficou verdadeira
+    for (int v = 0; resultado == 1 && v < g->n_vertices; v++) {
+        cores[v] = 0;
+        for (int cor = 1; cor <= k; cor++) {
+            if (interpretacao[v * k + cor] == 1) {
+                cores[v] = cor;
+                break;
+            }
+        }
+    }
+
+    liberar_formula(f);
+    liberarRastreado(interpretacao);
+    liberar_arvore(raiz);
+    return resultado;
+}
+
+/**
+ * Número de núcleo (core number) de cada vértice pela fila de baldes de Batagelj-Zaversnik,
+ * em O(n + m): a cada passo sai o vértice de menor grau restante.
+ * @param g Grafo (com adjacência CSR)
+ * @param nucleo Saída: núcleo de cada vértice
+ * @param ordem Saída: ordem em que os vértices saíram
+ * @return false se faltou memória
+ */
+bool calcularNucleos(Grafo *g, int *nucleo, int *ordem)
+{
+    int n = g->n_vertices;
+    int grau_max = 0;
+    for (int v = 0; v < n; v++) {
+        nucleo[v] = grauVertice(g, v);  // nucleo[] serve de grau restante durante o laço
+        if (nucleo[v] > grau_max) grau_max = nucleo[v];
+    }
+
+    int *balde = calloc((size_t)grau_max + 1, sizeof(int));  // Início de cada balde de grau em 'ordem'
+    int *pos = malloc((n > 0 ? n : 1) * sizeof(int));        // Posição de cada vértice em 'ordem'
+    if (!balde || !pos) {
+        free(balde);
+        free(pos);
+        return false;
+    }
+
+    // Ordena os vértices por grau (contagem) em 'ordem'
+    for (int v = 0; v < n; v++) balde[nucleo[v]]++;
+    for (int d = 0, inicio = 0; d <= grau_max; d++) {
+        int qtd = balde[d];
+        balde[d] = inicio;
+        inicio += qtd;
+    }
+    for (int v = 0; v < n; v++) {
+        pos[v] = balde[nucleo[v]]++;
+        ordem[pos[v]] = v;
+    }
+    for (int d = grau_max; d > 0; d--) balde[d] = balde[d - 1];
+    balde[0] = 0;
+
+    // Retira o vértice de menor grau; cada vizinho de grau maior desce um balde
+    for (int i = 0; i < n; i++) {
+        int v = ordem[i];
+        for (size_t j = g->adj_inicio[v]; j < g->adj_inicio[v + 1]; j++) {
+            int u = g->adj_vizinhos[j];
+            if (nucleo[u] > nucleo[v]) {
+                int du = nucleo[u];
+                int pu = pos[u];
+                int pw = balde[du];
+                int w = ordem[pw];
+                if (u != w) {  // Troca u com o primeiro do seu balde
+                    ordem[pu] = w;
+                    pos[w] = pu;
+                    ordem[pw] = u;
+                    pos[u] = pw;
+                }
+                balde[du]++;
+                nucleo[u]--;
+            }
+        }
+    }
+
+    free(balde);
+    free(pos);
+    return true;
+}
+
+/**
+ * Monta o subgrafo induzido pelos vértices com novo_indice[v] >= 0 (renumerados)
+ * @return false se faltou memória
+ */
+bool subgrafoInduzido(Grafo *g, const int *novo_indice, int n_novo, Grafo *sub)
+{
+    iniciarGrafo(sub);
+    sub->n_vertices = n_novo;
+    for (int u = 0; u < g->n_vertices; u++) {
+        if (novo_indice[u] < 0) continue;
+        for (size_t j = g->adj_inicio[u]; j < g->adj_inicio[u + 1]; j++) {
+            int v = g->adj_vizinhos[j];
+            if (v > u && novo_indice[v] >= 0 && !adicionarAresta(sub, novo_indice[u], novo_indice[v])) {
+                liberarGrafo(sub);
+                return false;
+            }
+        }
+    }
+    if (!construirAdjacencia(sub)) {
+        liberarGrafo(sub);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Dá ao vértice v a menor cor em 1..k que nenhum vizinho já colorido usa
+ * @param marca Vetor auxiliar com k+1 posições (reaproveitado entre chamadas, começa zerado)
+ * @param selo Valor único por chamada (ex.: v + 1), para não precisar zerar 'marca'
+ * @return A cor escolhida, ou 0 se todas as k cores estão ocupadas
+ */
+int corGulosa(Grafo *g, int v, int k, const int *cores, int *marca, int selo)
+{
+    for (size_t j = g->adj_inicio[v]; j < g->adj_inicio[v + 1]; j++) {
+        int c = cores[g->adj_vizinhos[j]];
+        if (c > 0 && c <= k) marca[c] = selo;
+    }
+    for (int c = 1; c <= k; c++) {
+        if (marca[c] != selo) return c;
+    }
+    return 0;
+}
+
+// 24ª ALTERAÇÃO: solver dedicado para K pequeno (domínios de cores em bits)
+//
+// Com K <= 64 o domínio de cada vértice (as cores que ele ainda pode receber) cabe num inteiro
+// sem sinal: tirar uma cor é um E-NÃO, o tamanho do domínio é um popcount e a menor cor é um
+// ctz. A busca é em profundidade com verificação adiante (colorir v tira a cor do domínio dos
+// vizinhos sem cor; domínio vazio é conflito na hora), escolhe o vértice de menor domínio
+// (DSatur; empate: maior grau) e só tenta cores até a maior já usada + 1, já que as cores são
+// intercambiáveis. Nenhuma CNF é montada. O mesmo código é instanciado por macro para domínios
+// de 8, 16, 32 e 64 bits, e colorirCSP usa o menor tipo em que K cabe.
+// GCP_MOTOR=sat manda tudo de volta para o SAT.
+
+#define MAX_CORES_CSP 64
+
+// Um nível da busca: o vértice colorido nele, as cores que faltam tentar e onde começa o desfazer
+typedef struct {
+    int v;
+    int maior_antes;     // Maior cor usada antes deste nível
+    size_t rastro;       // Início das remoções de domínio feitas por este nível
+    uint64_t opcoes;     // Cores ainda não tentadas (bit c-1 = cor c)
+} NivelCSP;
+
+// Corpo do solver para domínios do tipo TIPO (BITS bits). Os vértices sem cor ficam em
+// sem_cor[0 .. num_sem_cor-1]; quem sai vai para logo depois do fim, então voltar é só num_sem_cor++.
+#define DEFINIR_COLORIR_CSP(BITS, TIPO)                                                              \
+static int colorirCSP##BITS(Grafo *g, int k, int *cores)                                            \
+{                                                                                                    \
+    int n = g->n_vertices;                                                                           \
+    TIPO cheio = k >= BITS ? (TIPO)~(TIPO)0 : (TIPO)((1ULL << k) - 1);                              \
+    TIPO *dominio = malloc(((size_t)n + 1) * sizeof(TIPO));                                         \
+    int *sem_cor = malloc(((size_t)n + 1) * sizeof(int));                                           \
+    NivelCSP *pilha = malloc(((size_t)n + 1) * sizeof(NivelCSP));                                   \
+    int *rastro = malloc((g->adj_inicio[n] + 1) * sizeof(int));  /* Vértice que perdeu a cor */     \
+    int resultado = -1, num_sem_cor = n, profundidade = 0, maior = 0;                               \
+    size_t topo = 0;                                                                                 \
+    if (!dominio || !sem_cor || !pilha || !rastro) {                                                 \
+        printf("Erro: memória insuficiente no solver de domínios.\n");                               \
+        goto fim;                                                                                    \
+    }                                                                                                \
+    for (int v = 0; v < n; v++) {                                                                    \
+        dominio[v] = cheio;                                                                          \
+        cores[v] = 0;                                                                                \
+        sem_cor[v] = v;                                                                              \
+    }                                                                                                \
+                                                                                                     \
+    for (;;) {                                                                                       \
+        if (num_sem_cor == 0) {                                                                      \
+            resultado = 1;                                                                           \
+            break;                                                                                   \
+        }                                                                                            \
+        if (limiteEsgotado()) break;                                                                 \
+                                                                                                     \
+        /* DSatur: menor domínio (= mais cores distintas na vizinhança), empate pelo grau */        \
+        int escolhido = 0, menor = BITS + 1, grau_escolhido = -1;                                    \
+        for (int i = 0; i < num_sem_cor; i++) {                                                      \
+            int u = sem_cor[i];                                                                      \
+            int tam = __builtin_popcountll((uint64_t)dominio[u]);                                    \
+            int grau = grauVertice(g, u);                                                            \
+            if (tam < menor || (tam == menor && grau > grau_escolhido)) {                            \
+                escolhido = i;                                                                       \
+                menor = tam;                                                                         \
+                grau_escolhido = grau;                                                               \
+            }                                                                                        \
+        }                                                                                            \
+        NivelCSP *nivel = &pilha[profundidade++];                                                    \
+        nivel->v = sem_cor[escolhido];                                                               \
+        nivel->maior_antes = maior;                                                                  \
+        nivel->rastro = topo;                                                                        \
+        TIPO simetria = maior + 1 >= BITS ? (TIPO)~(TIPO)0 : (TIPO)((1ULL << (maior + 1)) - 1);      \
+        nivel->opcoes = (uint64_t)(dominio[nivel->v] & simetria);                                    \
+        sem_cor[escolhido] = sem_cor[num_sem_cor - 1];                                               \
+        sem_cor[--num_sem_cor] = nivel->v;                                                           \
+        if (++estatisticas_thread.decisoes >= 4096) descarregarEstatisticas();                       \
+                                                                                                     \
+        /* Tenta a próxima cor do nível do topo; sem cores, desfaz o nível e volta um */            \
+        for (;;) {                                                                                   \
+            nivel = &pilha[profundidade - 1];                                                        \
+            while (topo > nivel->rastro) dominio[rastro[--topo]] |= (TIPO)((TIPO)1 << (cores[nivel->v] - 1)); \
+            cores[nivel->v] = 0;                                                                     \
+            maior = nivel->maior_antes;                                                              \
+            if (nivel->opcoes == 0) {                                                                \
+                num_sem_cor++;  /* O vértice volta para a lista */                                   \
+                if (--profundidade == 0) {                                                           \
+                    resultado = 0;                                                                   \
+                    goto fim;                                                                        \
+                }                                                                                    \
+                estatisticas_thread.retrocessos++;                                                   \
+                continue;                                                                            \
+            }                                                                                        \
+            int cor = __builtin_ctzll(nivel->opcoes) + 1;                                            \
+            nivel->opcoes &= nivel->opcoes - 1;                                                      \
+            cores[nivel->v] = cor;                                                                   \
+            if (cor > maior) maior = cor;                                                            \
+                                                                                                     \
+            TIPO bit = (TIPO)((TIPO)1 << (cor - 1));                                                 \
+            bool conflito = false;                                                                   \
+            for (size_t j = g->adj_inicio[nivel->v]; j < g->adj_inicio[nivel->v + 1] && !conflito; j++) { \
+                int u = g->adj_vizinhos[j];                                                          \
+                if (cores[u] == 0 && (dominio[u] & bit)) {                                           \
+                    dominio[u] &= (TIPO)~bit;                                                        \
+                    rastro[topo++] = u;                                                              \
+                    estatisticas_thread.propagacoes++;                                               \
+                    conflito = dominio[u] == 0;                                                      \
+                }                                                                                    \
+            }                                                                                        \
+            if (!conflito) break;                                                                    \
+            estatisticas_thread.conflitos++;                                                         \
+            conflitos_nao_contados++;                                                                \
+        }                                                                                            \
+    }                                                                                                \
+                                                                                                     \
+fim:                                                                                                 \
+    free(dominio);                                                                                   \
+    free(sem_cor);                                                                                   \
+    free(pilha);                                                                                     \
+    free(rastro);                                                                                    \
+    return resultado;                                                                                \
+}
+
+DEFINIR_COLORIR_CSP(8, uint8_t)
+DEFINIR_COLORIR_CSP(16, uint16_t)
+DEFINIR_COLORIR_CSP(32, uint32_t)
+DEFINIR_COLORIR_CSP(64, uint64_t)
+
+/**
+ * k-coloração pelo solver de domínios em bits (K <= MAX_CORES_CSP), sem passar por CNF
+ * @param g Grafo
+ * @param k Quantidade de cores
+ * @param cores Saída: cores[v] em 1..k
+ * @return 1 se colorível, 0 se não, -1 em caso de erro ou limite esgotado
+ */
+int colorirCSP(Grafo *g, int k, int *cores)
+{
+    if (k < 1 || k > MAX_CORES_CSP) return -1;
+    double inicio = iniciarFase(FASE_CSP);
+    int resultado;
+    if (k <= 8) resultado = colorirCSP8(g, k, cores);
+    else if (k <= 16) resultado = colorirCSP16(g, k, cores);
+    else if (k <= 32) resultado = colorirCSP32(g, k, cores);
+    else resultado = colorirCSP64(g, k, cores);
+    registrarFase(FASE_CSP, inicio);
+    descarregarEstatisticas();
+    return resultado;
+}
+
+// O solver de domínios atende este K? (GCP_MOTOR=sat força o SAT)
+bool usarCSP(int k)
+{
+    const char *motor = getenv("GCP_MOTOR");
+    return k <= MAX_CORES_CSP && !(motor && strcmp(motor, "sat") == 0);
+}
+
+/**
+ * k-coloração com redução k-core: um vértice de grau < k sempre pode ser colorido por último,
+ * então sai do grafo (repetidamente, até sobrar o k-núcleo). Só o núcleo vai para o SAT; os
+ * vértices retirados voltam em ordem inversa, cada um com uma cor livre entre seus vizinhos.
+ * @param g Grafo
+ * @param k Quantidade de cores
+ * @param cores Saída: cores[v] em 1..k para cada vértice v (numerado a partir de 0)
+ * @return 1 se colorível, 0 se não, -1 em caso de erro
+ */
+int colorirComK(Grafo *g, int k, int *cores)
+{
+    int n = g->n_vertices;
+    if (g->num_lacos > 0 || k < 1) return n == 0 ? 1 : 0;
+
+    int *nucleo = malloc((n > 0 ? n : 1) * sizeof(int));
+    int *ordem = malloc((n > 0 ? n : 1) * sizeof(int));
+    int *novo_indice = malloc((n > 0 ? n : 1) * sizeof(int));
+    int *cores_nucleo = malloc((n > 0 ? n : 1) * sizeof(int));
+    int *marca = calloc((size_t)k + 1, sizeof(int));
+    int resultado = -1;
+    Grafo nucleo_k;
+    iniciarGrafo(&nucleo_k);
+
+    if (!nucleo || !ordem || !novo_indice || !cores_nucleo || !marca || !calcularNucleos(g, nucleo, ordem)) {
+        printf("Erro: memória insuficiente na redução k-core.\n");
+        goto fim;
+    }
+
+    // Fica no grafo reduzido só quem tem núcleo >= k
+    int mantidos = 0;
+    for (int v = 0; v < n; v++) {
+        novo_indice[v] = nucleo[v] >= k ? mantidos++ : -1;
+        cores[v] = 0;
+    }
+    if (mantidos < n && mostrar_detalhes) {
+        printf("Redução k-core: %d de %d vértice%s com grau < %d fora do SAT.\n",
+               n - mantidos, n, n > 1 ? "s" : "", k);
+    }
+
+    if (mantidos > 0) {
+        if (!subgrafoInduzido(g, novo_indice, mantidos, &nucleo_k)) {
+            printf("Erro: memória insuficiente na redução k-core.\n");
+            goto fim;
+        }
+        // 24ª ALTERAÇÃO: K pequeno vai para o solver de domínios em bits, sem CNF
+        resultado = usarCSP(k) ? colorirCSP(&nucleo_k, k, cores_nucleo) : colorirSAT(&nucleo_k, k, cores_nucleo);
+        if (resultado != 1) goto fim;
+        for (int v = 0; v < n; v++) {
+            if (novo_indice[v] >= 0) cores[v] = cores_nucleo[novo_indice[v]];
+        }
+    }
+
+    // Devolve os vértices retirados, do último ao primeiro: cada um tem < k vizinhos já coloridos
+    for (int i = n - 1; i >= 0; i--) {
+        int v = ordem[i];
+        if (novo_indice[v] < 0) cores[v] = corGulosa(g, v, k, cores, marca, v + 1);
+    }
+    resultado = 1;
+
+fim:
+    liberarGrafo(&nucleo_k);
+    free(nucleo);
+    free(ordem);
+    free(novo_indice);
+    free(cores_nucleo);
+    free(marca);
+    return resultado;
+}
+
+// 22ª ALTERAÇÃO: matriz de adjacência em bits para grafos densos
+//
+// Em grafo denso a lista CSR é maior que uma matriz n x n de bits, e as heurísticas passam o
+// tempo andando por ela. A matriz guarda uma linha de bits por vértice (palavras múltiplas de 4,
+// para caber em registradores AVX2) e as operações viram E/E-NÃO/popcount sobre linhas inteiras:
+// máscara de cores livres e saturação no DSatur, extração de conjuntos independentes no RLF.
+// Os núcleos dessas operações têm versão AVX2 e versão portável, escolhida em tempo de execução.
+
+#define MAX_VERTICES_MATRIZ 50000   // Acima disso a matriz passa de 300 MB
+#define MAX_VERTICES_RLF 2048       // O RLF custa O(n² · n/64): só em grafos menores
+
+typedef struct {
+    int n;             // Vértices
+    int palavras;      // Palavras de 64 bits por linha (múltiplo de 4)
+    uint64_t *linhas;  // n * palavras: bit u da linha v ligado se u e v são vizinhos
+} MatrizBits;
+
+// Núcleos sobre linhas de bits (tamanho sempre múltiplo de 4 palavras)
+typedef struct {
+    size_t (*contar_e)(const uint64_t *a, const uint64_t *b, int palavras);       // |a ∩ b|
+    size_t (*separar)(uint64_t *c, uint64_t *x, const uint64_t *linha, int palavras);  // x |= c ∩ linha; c -= linha; |c|
+    size_t (*e)(uint64_t *destino, const uint64_t *a, const uint64_t *b, int palavras);  // destino = a ∩ b; |destino|
+    size_t (*retirar)(uint64_t *a, const uint64_t *b, int palavras);  // 23ª ALTERAÇÃO: a -= b; |a|
+} NucleosBits;
+
+static size_t contarEEscalar(const uint64_t *a, const uint64_t *b, int palavras)
+{
+    size_t total = 0;
+    for (int w = 0; w < palavras; w++) total += (size_t)__builtin_popcountll(a[w] & b[w]);
+    return total;
+}
+
+static size_t separarEscalar(uint64_t *c, uint64_t *x, const uint64_t *linha, int palavras)
+{
+    size_t total = 0;
+    for (int w = 0; w < palavras; w++) {
+        x[w] |= c[w] & linha[w];
+        c[w] &= ~linha[w];
+        total += (size_t)__builtin_popcountll(c[w]);
+    }
+    return total;
+}
+
+static size_t eEscalar(uint64_t *destino, const uint64_t *a, const uint64_t *b, int palavras)
+{
+    size_t total = 0;
+    for (int w = 0; w < palavras; w++) {
+        destino[w] = a[w] & b[w];
+        total += (size_t)__builtin_popcountll(destino[w]);
+    }
+    return total;
+}
+
+static size_t retirarEscalar(uint64_t *a, const uint64_t *b, int palavras)
+{
+    size_t total = 0;
+    for (int w = 0; w < palavras; w++) {
+        a[w] &= ~b[w];
+        total += (size_t)__builtin_popcountll(a[w]);
+    }
+    return total;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// popcount de cada quarto de 64 bits (AVX2 não tem popcount vetorial: tabela de 4 bits com vpshufb)
+__attribute__((target("avx2")))
+static inline __m256i popcount256(__m256i v)
+{
+    const __m256i tabela = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i baixo = _mm256_set1_epi8(0x0f);
+    __m256i a = _mm256_shuffle_epi8(tabela, _mm256_and_si256(v, baixo));
+    __m256i b = _mm256_shuffle_epi8(tabela, _mm256_and_si256(_mm256_srli_epi16(v, 4), baixo));
+    return _mm256_sad_epu8(_mm256_add_epi8(a, b), _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static inline size_t somar256(__m256i v)
+{
+    return (size_t)(_mm256_extract_epi64(v, 0) + _mm256_extract_epi64(v, 1) +
+                    _mm256_extract_epi64(v, 2) + _mm256_extract_epi64(v, 3));
+}
+
+__attribute__((target("avx2")))
+static size_t contarEAVX2(const uint64_t *a, const uint64_t *b, int palavras)
+{
+    __m256i total = _mm256_setzero_si256();
+    for (int w = 0; w < palavras; w += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + w));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + w));
+        total = _mm256_add_epi64(total, popcount256(_mm256_and_si256(va, vb)));
+    }
+    return somar256(total);
+}
+
+__attribute__((target("avx2")))
+static size_t separarAVX2(uint64_t *c, uint64_t *x, const uint64_t *linha, int palavras)
+{
+    __m256i total = _mm256_setzero_si256();
+    for (int w = 0; w < palavras; w += 4) {
+        __m256i vc = _mm256_loadu_si256((const __m256i*)(c + w));
+        __m256i vl = _mm256_loadu_si256((const __m256i*)(linha + w));
+        __m256i vx = _mm256_loadu_si256((const __m256i*)(x + w));
+        _mm256_storeu_si256((__m256i*)(x + w), _mm256_or_si256(vx, _mm256_and_si256(vc, vl)));
+        vc = _mm256_andnot_si256(vl, vc);
+        _mm256_storeu_si256((__m256i*)(c + w), vc);
+        total = _mm256_add_epi64(total, popcount256(vc));
+    }
+    return somar256(total);
+}
+
+__attribute__((target("avx2")))
+static size_t eAVX2(uint64_t *destino, const uint64_t *a, const uint64_t *b, int palavras)
+{
+    __m256i total = _mm256_setzero_si256();
+    for (int w = 0; w < palavras; w += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + w));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + w));
+        __m256i vd = _mm256_and_si256(va, vb);
+        _mm256_storeu_si256((__m256i*)(destino + w), vd);
+        total = _mm256_add_epi64(total, popcount256(vd));
+    }
+    return somar256(total);
+}
+
+__attribute__((target("avx2")))
+static size_t retirarAVX2(uint64_t *a, const uint64_t *b, int palavras)
+{
+    __m256i total = _mm256_setzero_si256();
+    for (int w = 0; w < palavras; w += 4) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + w));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + w));
+        va = _mm256_andnot_si256(vb, va);
+        _mm256_storeu_si256((__m256i*)(a + w), va);
+        total = _mm256_add_epi64(total, popcount256(va));
+    }
+    return somar256(total);
+}
+#endif
+
+// Núcleos do processador atual (AVX2 se houver; ver temAVX2 na 21ª ALTERAÇÃO)
+static const NucleosBits *nucleosBits(void)
+{
+    static const NucleosBits escalar = { contarEEscalar, separarEscalar, eEscalar, retirarEscalar };
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static const NucleosBits avx2 = { contarEAVX2, separarAVX2, eAVX2, retirarAVX2 };
+    if (temAVX2()) return &avx2;
+#endif
+    return &escalar;
+}
+
+static inline const uint64_t *linhaMatriz(const MatrizBits *mb, int v)
+{
+    return mb->linhas + (size_t)v * mb->palavras;
+}
+
+/**
+ * A matriz compensa? Só até MAX_VERTICES_MATRIZ vértices e se não ocupar mais que o dobro
+ * da lista CSR (ou 1 MB, para grafos pequenos)
+ */
+bool matrizCompensa(const Grafo *g)
+{
+    if (g->n_vertices == 0 || g->n_vertices > MAX_VERTICES_MATRIZ) return false;
+    size_t palavras = (((size_t)g->n_vertices + 255) / 256) * 4;
+    size_t bytes_matriz = (size_t)g->n_vertices * palavras * sizeof(uint64_t);
+    size_t bytes_csr = g->adj_inicio[g->n_vertices] * sizeof(int);
+    return bytes_matriz <= 2 * bytes_csr || bytes_matriz <= ((size_t)1 << 20);
+}
+
+/**
+ * Monta a matriz de bits a partir da adjacência CSR
+ * @param posicao Linha de cada vértice na matriz, ou -1 para deixar o vértice de fora
+ *                (23ª ALTERAÇÃO; NULL = todos os vértices, na ordem do grafo)
+ * @param n Quantidade de vértices na matriz
+ * @return false se faltou memória
+ */
+bool montarMatrizBits(const Grafo *g, const int *posicao, int n, MatrizBits *mb)
+{
+    mb->n = n;
+    mb->palavras = ((n + 255) / 256) * 4;
+    mb->linhas = calloc((size_t)n * mb->palavras, sizeof(uint64_t));
+    if (!mb->linhas) return false;
+    for (int v = 0; v < g->n_vertices; v++) {
+        int pv = posicao ? posicao[v] : v;
+        if (pv < 0) continue;
+        uint64_t *linha = mb->linhas + (size_t)pv * mb->palavras;
+        for (size_t j = g->adj_inicio[v]; j < g->adj_inicio[v + 1]; j++) {
+            int u = posicao ? posicao[g->adj_vizinhos[j]] : g->adj_vizinhos[j];
+            if (u >= 0) linha[u / 64] |= 1ULL << (u % 64);
+        }
+    }
+    return true;
+}
+
+void liberarMatrizBits(MatrizBits *mb)
+{
+    free(mb->linhas);
+    mb->linhas = NULL;
+}
+
+/**
+ * DSatur sobre a matriz: colore primeiro o vértice com mais cores distintas na vizinhança
+ * (empate: maior grau), com a menor cor livre. Cada vértice guarda a máscara das cores dos
+ * vizinhos, então a cor livre é o primeiro bit desligado e a saturação sobe em O(1) por vizinho.
+ * @param g Grafo (para os graus)
+ * @param cores Saída: cores[v] em 1..k
+ * @return k (quantidade de cores) ou 0 se faltou memória
+ */
+int colorirDSaturBits(const MatrizBits *mb, const Grafo *g, int *cores)
+{
+    const NucleosBits *nb = nucleosBits();
+    int n = mb->n, palavras = mb->palavras, grau_max = 0;
+    for (int v = 0; v < n; v++) {
+        if (grauVertice(g, v) > grau_max) grau_max = grauVertice(g, v);
+    }
+    int palavras_cor = (grau_max + 1 + 63) / 64;  // Nunca são precisas mais que grau_max + 1 cores
+
+    uint64_t *sem_cor = calloc((size_t)palavras, sizeof(uint64_t));
+    uint64_t *vizinhos = malloc((size_t)palavras * sizeof(uint64_t));
+    uint64_t *cores_vizinhas = calloc((size_t)n * palavras_cor, sizeof(uint64_t));
+    int *saturacao = calloc((size_t)n, sizeof(int));
+    int k = 0;
+    if (!sem_cor || !vizinhos || !cores_vizinhas || !saturacao) goto fim;
+
+    for (int v = 0; v < n; v++) sem_cor[v / 64] |= 1ULL << (v % 64);
+    for (int passo = 0; passo < n; passo++) {
+        // Vértice sem cor de maior saturação (empate: maior grau)
+        int v = -1;
+        for (int w = 0; w < palavras; w++) {
+            for (uint64_t x = sem_cor[w]; x; x &= x - 1) {
+                int u = 64 * w + __builtin_ctzll(x);
+                if (v < 0 || saturacao[u] > saturacao[v] ||
+                    (saturacao[u] == saturacao[v] && grauVertice(g, u) > grauVertice(g, v))) v = u;
+            }
+        }
+
+        // Menor cor livre: primeiro bit desligado da máscara das cores vizinhas
+        const uint64_t *mascara = cores_vizinhas + (size_t)v * palavras_cor;
+        int cor = 0;
+        for (int w = 0; w < palavras_cor && !cor; w++) {
+            if (~mascara[w]) cor = 64 * w + __builtin_ctzll(~mascara[w]) + 1;
+        }
+        cores[v] = cor;
+        if (cor > k) k = cor;
+        sem_cor[v / 64] &= ~(1ULL << (v % 64));
+
+        // Vizinhos ainda sem cor ganham a cor na máscara (e saturação, se ela é nova)
+        nb->e(vizinhos, linhaMatriz(mb, v), sem_cor, palavras);
+        uint64_t bit = 1ULL << ((cor - 1) % 64);
+        for (int w = 0; w < palavras; w++) {
+            for (uint64_t x = vizinhos[w]; x; x &= x - 1) {
+                int u = 64 * w + __builtin_ctzll(x);
+                uint64_t *m = cores_vizinhas + (size_t)u * palavras_cor + (cor - 1) / 64;
+                if (!(*m & bit)) {
+                    *m |= bit;
+                    saturacao[u]++;
+                }
+            }
+        }
+    }
+
+fim:
+    free(sem_cor);
+    free(vizinhos);
+    free(cores_vizinhas);
+    free(saturacao);
+    return k;
+}
+
+/**
+ * RLF (Leighton): cada cor é um conjunto independente extraído dos vértices restantes. O primeiro
+ * vértice da cor é o de mais vizinhos restantes; os seguintes, os de mais vizinhos entre os já
+ * excluídos da cor (assim a cor "engole" o máximo de arestas). Escolher um vértice tira os
+ * vizinhos dele dos candidatos com um E-NÃO sobre a linha inteira.
+ * @param cores Saída: cores[v] em 1..k
+ * @return k (quantidade de cores) ou 0 se faltou memória
+ */
+int colorirRLFBits(const MatrizBits *mb, int *cores)
+{
+    const NucleosBits *nb = nucleosBits();
+    int n = mb->n, palavras = mb->palavras;
+    uint64_t *restantes = calloc((size_t)palavras, sizeof(uint64_t));
+    uint64_t *candidatos = malloc((size_t)palavras * sizeof(uint64_t));
+    uint64_t *excluidos = malloc((size_t)palavras * sizeof(uint64_t));
+    int k = 0;
+    if (!restantes || !candidatos || !excluidos) goto fim;
+
+    for (int v = 0; v < n; v++) restantes[v / 64] |= 1ULL << (v % 64);
+    for (int faltam = n; faltam > 0;) {
+        k++;
+        memcpy(candidatos, restantes, (size_t)palavras * sizeof(uint64_t));
+        memset(excluidos, 0, (size_t)palavras * sizeof(uint64_t));
+        const uint64_t *referencia = restantes;  // Primeiro vértice: mais vizinhos restantes
+        for (size_t sobram = (size_t)faltam; sobram > 0;) {
+            int v = -1;
+            size_t melhor = 0;
+            for (int w = 0; w < palavras; w++) {
+                for (uint64_t x = candidatos[w]; x; x &= x - 1) {
+                    int u = 64 * w + __builtin_ctzll(x);
+                    size_t valor = nb->contar_e(linhaMatriz(mb, u), referencia, palavras);
+                    if (v < 0 || valor > melhor) {
+                        v = u;
+                        melhor = valor;
+                    }
+                }
+            }
+            cores[v] = k;
+            faltam--;
+            candidatos[v / 64] &= ~(1ULL << (v % 64));
+            restantes[v / 64] &= ~(1ULL << (v % 64));
+            sobram = nb->separar(candidatos, excluidos, linhaMatriz(mb, v), palavras);
+            referencia = excluidos;
+        }
+    }
+
+fim:
+    free(restantes);
+    free(candidatos);
+    free(excluidos);
+    return k;
+}
+
+/**
+ * Coloração heurística para grafos densos: DSatur (e RLF, se o grafo é pequeno) sobre a matriz
+ * de bits, ficando com a que gastar menos cores
+ * @param g Grafo
+ * @param cores Saída: cores[v] em 1..k
+ * @return k, ou 0 se a matriz não compensa para este grafo (ou faltou memória)
+ */
+int colorirDensoBits(Grafo *g, int *cores)
+{
+    if (!matrizCompensa(g)) return 0;
+    MatrizBits mb;
+    if (!montarMatrizBits(g, NULL, g->n_vertices, &mb)) return 0;
+    int k = colorirDSaturBits(&mb, g, cores);
+    if (k > 0 && g->n_vertices <= MAX_VERTICES_RLF) {
+        int *outra = malloc((size_t)g->n_vertices * sizeof(int));
+        int k_rlf = outra ? colorirRLFBits(&mb, outra) : 0;
+        if (k_rlf > 0 && k_rlf < k) {
+            memcpy(cores, outra, (size_t)g->n_vertices * sizeof(int));
+            k = k_rlf;
+        }
+        free(outra);
+    }
+    liberarMatrizBits(&mb);
+    return k;
+}
+
+// 11ª ALTERAÇÃO: componentes conexas resolvidas em paralelo
+//
+// O número cromático do grafo é o maior entre os das componentes conexas, então cada
+// componente vira um problema separado (CNF bem menor) e várias rodam ao mesmo tempo.
+
+// Uma componente conexa: seus vértices ficam contíguos em um vetor compartilhado
+typedef struct {
+    int *vertices;          // Vértices da componente (numeração do grafo original)
+    int n;                  // Quantidade de vértices
+    int limite_superior;    // Cores usadas pela coloração gulosa (sempre válida)
+    bool tem_aresta;        // Se há pelo menos uma aresta (então precisa de 2 cores ou mais)
+} Componente;
+
+// Estado compartilhado entre as threads que resolvem componentes
+typedef struct {
+    Grafo *g;
+    Componente *comps;
+    int num_comps;
+    int *indice_local;      // Posição de cada vértice dentro da sua componente
+    int *cores;             // Coloração do grafo inteiro (começa com a gulosa)
+    int k_fixo;             // K pedido (teste único) ou 0 para achar o mínimo (teste iterativo)
+    bool detalhar;          // Mostra cada K testado (quando só uma componente vai para o SAT)
+    int proxima;            // Próxima componente a pegar (atômico)
+    int maior_k;            // Maior K já necessário em alguma componente (atômico)
+    int resultado;          // 1 tudo certo, 0 alguma componente não colore com k_fixo, -1 erro (atômico)
+    ControleTrabalho *controle;  // 14ª ALTERAÇÃO: prazo de quem chamou, herdado pelas threads
+} TrabalhoComponentes;
+
+int threads_por_instancia = 0;  // 15ª ALTERAÇÃO: se > 0, vale mais que GCP_THREADS (modo em lote)
+
+/**
+ * Quantidade de threads de trabalho: GCP_THREADS ou o número de processadores
+ */
+int numeroThreads(void)
+{
+    if (threads_por_instancia > 0) return threads_por_instancia;
+    const char *env = getenv("GCP_THREADS");
+    long n = env ? atol(env) : sysconf(_SC_NPROCESSORS_ONLN);
+    return n < 1 ? 1 : (n > 256 ? 256 : (int)n);
+}
+
+// Union-find com compressão de caminho (por divisão pela metade) e união por tamanho
+static int acharRaiz(int *pai, int x)
+{
+    while (pai[x] != x) {
+        pai[x] = pai[pai[x]];
+        x = pai[x];
+    }
+    return x;
+}
+
+static void unir(int *pai, int *tamanho, int a, int b)
+{
+    a = acharRaiz(pai, a);
+    b = acharRaiz(pai, b);
+    if (a == b) return;
+    if (tamanho[a] < tamanho[b]) { int t = a; a = b; b = t; }
+    pai[b] = a;
+    tamanho[a] += tamanho[b];
+}
+
+/**
+ * Monta o grafo de uma componente (vértices renumerados 0..n-1 pela ordem em c->vertices)
+ * @return false se faltou memória
+ */
+bool subgrafoDaComponente(Grafo *g, Componente *c, const int *indice_local, Grafo *sub)
+{
+    iniciarGrafo(sub);
+    sub->n_vertices = c->n;
+    for (int i = 0; i < c->n; i++) {
+        int u = c->vertices[i];
+        for (size_t j = g->adj_inicio[u]; j < g->adj_inicio[u + 1]; j++) {
+            int v = g->adj_vizinhos[j];
+            if (v > u && !adicionarAresta(sub, i, indice_local[v])) {
+                liberarGrafo(sub);
+                return false;
+            }
+        }
+    }
+    if (!construirAdjacencia(sub)) {
+        liberarGrafo(sub);
+        return false;
+    }
+    return true;
+}
+
+// Sobe *alvo para pelo menos 'valor' (máximo atômico)
+static void maximoAtomico(int *alvo, int valor)
+{
+    int atual = __atomic_load_n(alvo, __ATOMIC_RELAXED);
+    while (atual < valor && !__atomic_compare_exchange_n(alvo, &atual, valor, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Laço de cada thread: pega a próxima componente e acha o menor K >= maior_k que a colore
+static void *trabalhadorComponentes(void *arg)
+{
+    TrabalhoComponentes *t = arg;
+    controle_atual = t->controle;
+    for (;;) {
+        int i = __atomic_fetch_add(&t->proxima, 1, __ATOMIC_RELAXED);
+        if (i >= t->num_comps || __atomic_load_n(&t->resultado, __ATOMIC_RELAXED) != 1) break;
+
+        Componente *c = &t->comps[i];
+        int k = t->k_fixo ? t->k_fixo : __atomic_load_n(&t->maior_k, __ATOMIC_RELAXED);
+        if (k >= c->limite_superior) continue;  // A coloração gulosa já cabe: nada a resolver
+
+        Grafo sub;
+        int *cores_local = malloc((size_t)c->n * sizeof(int));
+        if (!cores_local || !subgrafoDaComponente(t->g, c, t->indice_local, &sub)) {
+            free(cores_local);
+            __atomic_store_n(&t->resultado, -1, __ATOMIC_RELAXED);
+            break;
+        }
+
+        for (;;) {
+            if (k >= c->limite_superior) break;  // Outra componente já exigiu cores suficientes
+
+            if (t->detalhar) printf("Testando coloração com %d cor%s...\n", k, k > 1 ? "es" : "");
+            int r = colorirComK(&sub, k, cores_local);
+            if (r < 0) {
+                __atomic_store_n(&t->resultado, -1, __ATOMIC_RELAXED);
+                break;
+            }
+            if (r == 1) {
+                for (int j = 0; j < c->n; j++) t->cores[c->vertices[j]] = cores_local[j];
+                break;
+            }
+            if (t->detalhar) printf("✘ Nao eh possivel com %d cor%s.\n\n", k, k > 1 ? "es" : "");
+            if (t->k_fixo) {
+                __atomic_store_n(&t->resultado, 0, __ATOMIC_RELAXED);  // As outras threads podem parar
+                break;
+            }
+
+            // Provado que esta componente precisa de mais de k cores: o grafo todo também
+            k++;
+            maximoAtomico(&t->maior_k, k);
+            if (t->controle) maximoAtomico(&t->controle->limite_inferior, k);  // 18ª ALTERAÇÃO
+            int global = __atomic_load_n(&t->maior_k, __ATOMIC_RELAXED);
+            if (global > k) k = global;
+        }
+
+        liberarGrafo(&sub);
+        free(cores_local);
+    }
+    return NULL;
+}
+
+static int compararComponentes(const void *a, const void *b)
+{
+    const Componente *x = a, *y = b;
+    if (x->limite_superior != y->limite_superior) return y->limite_superior - x->limite_superior;
+    return y->n - x->n;
+}
+
+// 23ª ALTERAÇÃO: clique máxima exata com bits (BBMC)
+//
+// ω(G) é limite inferior de χ(G): se a coloração heurística usa ω cores ela já é ótima, sem
+// nenhuma chamada ao SAT, e o laço de K pode começar em ω. A busca é o branch-and-bound de
+// San Segundo (BBMC) sobre a matriz de bits da 22ª ALTERAÇÃO: em cada nó os candidatos são
+// coloridos gulosamente em classes independentes (E-NÃO por linha) e um vértice só é expandido
+// se tamanho + cor dele passa da melhor clique. Só entram na matriz os vértices com núcleo >=
+// clique gulosa (os outros não formam clique maior), em ordem decrescente de núcleo.
+// Os ramos da raiz são repartidos entre as threads. O prazo vem de GCP_PRAZO_CLIQUE (segundos,
+// padrão 1) e conta desde a clique gulosa; se esgotar, fica a melhor clique achada, que continua
+// sendo um limite inferior.
+
+#define PRAZO_CLIQUE_PADRAO 1.0
+
+int cliqueGulosa(Grafo *g, const int *nucleo, const int *ordem, double prazo);  // 15ª ALTERAÇÃO
+
+// Memória de um nível da busca (alocada na primeira vez que a busca chega nele)
+typedef struct {
+    uint64_t *candidatos;   // Candidatos deste nível
+    uint64_t *fila;         // Candidatos ainda sem cor (coloração do nível)
+    uint64_t *classe;       // Quem ainda pode entrar na classe de cor atual
+    int *ordem;             // Vértices listados, na ordem das classes de cor
+    int *cor;               // Cor de cada vértice listado (limite da clique que ele pode formar)
+    int capacidade;         // Tamanho de ordem/cor
+} NivelClique;
+
+// Estado compartilhado da busca
+typedef struct {
+    const MatrizBits *mb;
+    const NucleosBits *nb;
+    double prazo;               // Instante limite (0 = sem prazo próprio)
+    int melhor;                 // Tamanho da melhor clique (atômico)
+    int *melhor_clique;         // Vértices dela (linhas da matriz), protegidos pela trava
+    pthread_mutex_t trava;
+    NivelClique raiz;           // Coloração da raiz (ramos repartidos entre as threads)
+    int num_raiz;
+    int proxima_raiz;           // Próximo ramo a pegar, contado do fim de raiz.ordem (atômico)
+    int parar;                  // Prazo esgotado ou falta de memória (atômico)
+    ControleTrabalho *controle; // Limites de quem chamou, herdados pelas threads
+} BuscaClique;
+
+// Estado de uma thread
+typedef struct {
+    BuscaClique *b;
+    NivelClique **niveis;
+    int num_niveis;
+    int *atual;                 // Clique em construção
+    uint64_t *restantes;        // Raiz: vértices ainda não descartados por ramos anteriores
+    int descartados_ate;        // Raiz: ramos >= este índice já saíram de 'restantes'
+    long long nos;
+} ThreadClique;
+
+// Aloca os vetores de um nível (o tamanho de ordem/cor cresce com ajustarNivelClique)
+static bool prepararNivelClique(NivelClique *nv, int palavras)
+{
+    memset(nv, 0, sizeof(*nv));
+    nv->candidatos = malloc((size_t)palavras * sizeof(uint64_t));
+    nv->fila = malloc((size_t)palavras * sizeof(uint64_t));
+    nv->classe = malloc((size_t)palavras * sizeof(uint64_t));
+    return nv->candidatos && nv->fila && nv->classe;
+}
+
+static bool ajustarNivelClique(NivelClique *nv, int tamanho)
+{
+    if (tamanho <= nv->capacidade) return true;
+    int *ordem = realloc(nv->ordem, (size_t)tamanho * sizeof(int));
+    if (ordem) nv->ordem = ordem;
+    int *cor = realloc(nv->cor, (size_t)tamanho * sizeof(int));
+    if (cor) nv->cor = cor;
+    if (!ordem || !cor) return false;
+    nv->capacidade = tamanho;
+    return true;
+}
+
+static void liberarNivelClique(NivelClique *nv)
+{
+    free(nv->candidatos);
+    free(nv->fila);
+    free(nv->classe);
+    free(nv->ordem);
+    free(nv->cor);
+}
+
+// Nível 'd' da thread, criado se ainda não existe (NULL se faltou memória)
+static NivelClique *nivelClique(ThreadClique *t, int d)
+{
+    if (d >= t->num_niveis) {
+        int novo = d + 8;
+        NivelClique **niveis = realloc(t->niveis, (size_t)novo * sizeof(NivelClique*));
+        if (!niveis) return NULL;
+        for (int i = t->num_niveis; i < novo; i++) niveis[i] = NULL;
+        t->niveis = niveis;
+        t->num_niveis = novo;
+    }
+    if (!t->niveis[d]) {
+        NivelClique *nv = malloc(sizeof(NivelClique));
+        if (!nv) return NULL;
+        bool ok = prepararNivelClique(nv, t->b->mb->palavras);
+        t->niveis[d] = nv;
+        if (!ok) return NULL;
+    }
+    return t->niveis[d];
+}
+
+/**
+ * Colore os candidatos do nível em classes independentes (menor linha primeiro) e lista,
+ * na ordem das classes, só os vértices com cor >= minimo: os de cor menor nunca passariam
+ * da melhor clique e não precisam ser expandidos
+ * @return Quantos vértices foram listados (-1 se faltou memória)
+ */
+static int colorirCandidatosClique(const BuscaClique *b, NivelClique *nv, size_t num_candidatos, int minimo)
+{
+    int palavras = b->mb->palavras, listados = 0;
+    if (!ajustarNivelClique(nv, (int)num_candidatos)) return -1;
+    memcpy(nv->fila, nv->candidatos, (size_t)palavras * sizeof(uint64_t));
+    size_t sem_cor = num_candidatos;
+    for (int cor = 1; sem_cor > 0; cor++) {
+        memcpy(nv->classe, nv->fila, (size_t)palavras * sizeof(uint64_t));
+        size_t cabem = sem_cor;
+        int w = 0;
+        while (cabem > 0) {
+            while (nv->classe[w] == 0) w++;
+            int v = 64 * w + __builtin_ctzll(nv->classe[w]);
+            nv->fila[w] &= ~(1ULL << (v % 64));
+            nv->classe[w] &= ~(1ULL << (v % 64));
+            sem_cor--;
+            if (cor >= minimo) {
+                nv->ordem[listados] = v;
+                nv->cor[listados++] = cor;
+            }
+            cabem = b->nb->retirar(nv->classe, linhaMatriz(b->mb, v), palavras);
+        }
+    }
+    return listados;
+}
+
+// Guarda a clique atual se ela é a maior até agora
+static void registrarClique(ThreadClique *t, int tamanho)
+{
+    BuscaClique *b = t->b;
+    if (tamanho <= __atomic_load_n(&b->melhor, __ATOMIC_RELAXED)) return;
+    pthread_mutex_lock(&b->trava);
+    if (tamanho > b->melhor) {
+        memcpy(b->melhor_clique, t->atual, (size_t)tamanho * sizeof(int));
+        __atomic_store_n(&b->melhor, tamanho, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&b->trava);
+}
+
+// A busca deve parar? (prazo próprio e limites de quem chamou, consultados a cada 1024 nós)
+static bool pararClique(ThreadClique *t)
+{
+    BuscaClique *b = t->b;
+    if ((++t->nos & 1023) == 0) {
+        if ((b->prazo > 0 && segundosAgora() >= b->prazo) || limiteEsgotado()) {
+            __atomic_store_n(&b->parar, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return __atomic_load_n(&b->parar, __ATOMIC_RELAXED);
+}
+
+/**
+ * Expande o vértice v com candidatos P ∩ N(v), onde P são os candidatos do nível d
+ * @param tamanho Vértices na clique atual, já contando v
+ */
+static void expandirClique(ThreadClique *t, const uint64_t *candidatos, int v, int d, int tamanho)
+{
+    BuscaClique *b = t->b;
+    int palavras = b->mb->palavras;
+    t->atual[tamanho - 1] = v;
+
+    NivelClique *nv = nivelClique(t, d);
+    if (!nv) {
+        __atomic_store_n(&b->parar, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    size_t num = b->nb->e(nv->candidatos, candidatos, linhaMatriz(b->mb, v), palavras);
+    if (num == 0) {
+        registrarClique(t, tamanho);
+        return;
+    }
+    int listados = colorirCandidatosClique(b, nv, num, __atomic_load_n(&b->melhor, __ATOMIC_RELAXED) - tamanho + 1);
+    if (listados < 0) {
+        __atomic_store_n(&b->parar, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    // Da maior cor para a menor: quando tamanho + cor não passa da melhor, nenhum outro passa
+    for (int i = listados - 1; i >= 0; i--) {
+        if (tamanho + nv->cor[i] <= __atomic_load_n(&b->melhor, __ATOMIC_RELAXED) || pararClique(t)) return;
+        int u = nv->ordem[i];
+        expandirClique(t, nv->candidatos, u, d + 1, tamanho + 1);
+        nv->candidatos[u / 64] &= ~(1ULL << (u % 64));
+    }
+}
+
+// Laço de cada thread: pega ramos da raiz, da maior cor para a menor
+static void *trabalhadorClique(void *arg)
+{
+    ThreadClique *t = arg;
+    BuscaClique *b = t->b;
+    controle_atual = b->controle;
+    for (;;) {
+        int i = b->num_raiz - 1 - __atomic_fetch_add(&b->proxima_raiz, 1, __ATOMIC_RELAXED);
+        if (i < 0 || b->raiz.cor[i] <= __atomic_load_n(&b->melhor, __ATOMIC_RELAXED) || pararClique(t)) break;
+
+        // Candidatos do ramo i: a raiz menos os ramos i, i+1, ... (os de cima já foram explorados)
+        while (t->descartados_ate > i) {
+            int u = b->raiz.ordem[--t->descartados_ate];
+            t->restantes[u / 64] &= ~(1ULL << (u % 64));
+        }
+        expandirClique(t, t->restantes, b->raiz.ordem[i], 0, 1);
+    }
+    return NULL;
+}
+
+/**
+ * Tamanho da clique máxima (BBMC com bits, ramos da raiz repartidos entre as threads)
+ * @param g Grafo (com adjacência CSR)
+ * @param prazo Segundos para a gulosa e a busca (<= 0: sem prazo próprio; os limites do controle atual valem sempre)
+ * @param exata Saída: true se a busca terminou (o valor é ω); false se é só a maior clique achada
+ * @return Tamanho da maior clique achada (0 para o grafo vazio)
+ */
+int cliqueMaxima(Grafo *g, double prazo, bool *exata)
+{
+    int n = g->n_vertices;
+    *exata = n == 0;
+    if (n == 0) return 0;
+    double fim = prazo > 0 ? segundosAgora() + prazo : 0;  // O prazo vale também para a gulosa
+
+    int *nucleo = malloc((size_t)n * sizeof(int));
+    int *ordem = malloc((size_t)n * sizeof(int));
+    int *posicao = malloc((size_t)n * sizeof(int));
+    if (!nucleo || !ordem || !posicao || !calcularNucleos(g, nucleo, ordem)) {
+        free(nucleo);
+        free(ordem);
+        free(posicao);
+        return 1;
+    }
+
+    // Clique gulosa como ponto de partida; na matriz, só quem pode estar numa clique desse tamanho
+    int inferior = cliqueGulosa(g, nucleo, ordem, fim);
+    if (inferior < 1) inferior = 1;
+    if ((fim > 0 && segundosAgora() >= fim) || limiteEsgotado()) {
+        free(nucleo);
+        free(ordem);
+        free(posicao);
+        return inferior;  // O prazo acabou na gulosa: fica a clique dela (exata continua false)
+    }
+    int n_sub = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        int v = ordem[i];
+        posicao[v] = nucleo[v] + 1 >= inferior ? n_sub++ : -1;
+    }
+    free(nucleo);
+    free(ordem);
+
+    MatrizBits mb;
+    if (n_sub > MAX_VERTICES_MATRIZ || !montarMatrizBits(g, posicao, n_sub, &mb)) {
+        free(posicao);
+        return inferior;  // Grande demais para a matriz: fica a gulosa
+    }
+    free(posicao);
+
+    BuscaClique b;
+    memset(&b, 0, sizeof(b));
+    b.mb = &mb;
+    b.nb = nucleosBits();
+    b.prazo = fim;
+    b.melhor = inferior - 1;  // A busca reencontra uma clique do tamanho da gulosa
+    b.controle = controle_atual;
+    b.melhor_clique = malloc((size_t)n_sub * sizeof(int));
+    pthread_mutex_init(&b.trava, NULL);
+
+    // Raiz: todos os vértices da matriz, coloridos uma vez
+    int num_threads = numeroThreads();
+    ThreadClique *threads = calloc((size_t)num_threads, sizeof(ThreadClique));
+    bool ok = b.melhor_clique && threads && prepararNivelClique(&b.raiz, mb.palavras);
+    if (ok) {
+        memset(b.raiz.candidatos, 0, (size_t)mb.palavras * sizeof(uint64_t));
+        for (int v = 0; v < n_sub; v++) b.raiz.candidatos[v / 64] |= 1ULL << (v % 64);
+        b.num_raiz = colorirCandidatosClique(&b, &b.raiz, (size_t)n_sub, inferior);
+        ok = b.num_raiz >= 0;
+    }
+    if (ok && num_threads > b.num_raiz) num_threads = b.num_raiz > 0 ? b.num_raiz : 1;
+    for (int i = 0; ok && i < num_threads; i++) {
+        threads[i].b = &b;
+        threads[i].atual = malloc((size_t)n_sub * sizeof(int));
+        threads[i].restantes = malloc((size_t)mb.palavras * sizeof(uint64_t));
+        threads[i].descartados_ate = b.num_raiz;
+        ok = threads[i].atual && threads[i].restantes;
+        if (ok) memcpy(threads[i].restantes, b.raiz.candidatos, (size_t)mb.palavras * sizeof(uint64_t));
+    }
+
+    if (ok && num_threads == 1) {
+        trabalhadorClique(&threads[0]);
+    } else if (ok) {
+        pthread_t *ids = malloc((size_t)num_threads * sizeof(pthread_t));
+        int criadas = 0;
+        for (int i = 0; ids && i < num_threads; i++) {
+            if (pthread_create(&ids[i], NULL, trabalhadorClique, &threads[i]) == 0) criadas++;
+        }
+        if (criadas == 0) trabalhadorClique(&threads[0]);
+        for (int i = 0; i < criadas; i++) pthread_join(ids[i], NULL);
+        free(ids);
+    }
+    *exata = ok && !b.parar;
+
+    for (int i = 0; threads && i < num_threads; i++) {
+        for (int d = 0; d < threads[i].num_niveis; d++) {
+            if (threads[i].niveis[d]) liberarNivelClique(threads[i].niveis[d]);
+            free(threads[i].niveis[d]);
+        }
+        free(threads[i].niveis);
+        free(threads[i].atual);
+        free(threads[i].restantes);
+    }
+    free(threads);
+    liberarNivelClique(&b.raiz);
+    pthread_mutex_destroy(&b.trava);
+    free(b.melhor_clique);
+    liberarMatrizBits(&mb);
+    return b.melhor > inferior ? b.melhor : inferior;
+}
+
+/**
+ * Colore o grafo componente por componente, em paralelo.
+ * Cada componente começa com uma coloração gulosa (ordem de remoção do k-core invertida);
+ * só vão para o SAT as que usaram mais cores do que o necessário até agora.
+ * @param g Grafo
+ * @param k_fixo K pedido (teste único) ou 0 para achar o menor K (teste iterativo)
+ * @param omega_conhecido Clique (ou outro limite inferior) que quem chamou já achou; 0 = procurar aqui
+ * @param cores Saída: cores[v] para cada vértice
+ * @param k_usado Saída: quantidade de cores da coloração devolvida
+ * @return 1 se colorível (com k_fixo, ou achou o mínimo), 0 se não colorível com k_fixo, -1 em erro.
+ *         Se o -1 veio de um limite esgotado, cores e k_usado têm a melhor coloração achada.
+ */
+int resolverComponentes(Grafo *g, int k_fixo, int omega_conhecido, int *cores, int *k_usado)
+{
+    int n = g->n_vertices;
+    *k_usado = 0;
+    if (n == 0) return 1;
+    if (g->num_lacos > 0) return 0;
+
+    int *pai = malloc((size_t)n * sizeof(int));
+    int *tamanho = malloc((size_t)n * sizeof(int));
+    int *id_comp = malloc((size_t)n * sizeof(int));
+    int *vertices = malloc((size_t)n * sizeof(int));
+    int *indice_local = malloc((size_t)n * sizeof(int));
+    int *nucleo = malloc((size_t)n * sizeof(int));
+    int *ordem = malloc((size_t)n * sizeof(int));
+    int *marca = calloc((size_t)n + 2, sizeof(int));
+    Componente *comps = NULL;
+    int resultado = -1;
+
+    if (!pai || !tamanho || !id_comp || !vertices || !indice_local || !nucleo || !ordem || !marca ||
+        !calcularNucleos(g, nucleo, ordem)) {
+        printf("Erro: memória insuficiente ao separar as componentes.\n");
+        goto fim;
+    }
+
+    // Union-find sobre as arestas distintas
+    for (int v = 0; v < n; v++) { pai[v] = v; tamanho[v] = 1; }
+    for (int u = 0; u < n; u++) {
+        for (size_t j = g->adj_inicio[u]; j < g->adj_inicio[u + 1]; j++) {
+            if (g->adj_vizinhos[j] > u) unir(pai, tamanho, u, g->adj_vizinhos[j]);
+        }
+    }
+
+    // Numera as componentes e agrupa os vértices de cada uma (contagem)
+    int num_comps = 0;
+    for (int v = 0; v < n; v++) id_comp[v] = -1;
+    for (int v = 0; v < n; v++) {
+        int r = acharRaiz(pai, v);
+        if (id_comp[r] < 0) id_comp[r] = num_comps++;
+        id_comp[v] = id_comp[r];
+    }
+    comps = calloc((size_t)num_comps, sizeof(Componente));
+    if (!comps) {
+        printf("Erro: memória insuficiente ao separar as componentes.\n");
+        goto fim;
+    }
+    for (int v = 0; v < n; v++) comps[id_comp[v]].n++;
+    for (int c = 0, inicio = 0; c < num_comps; c++) {
+        comps[c].vertices = vertices + inicio;
+        inicio += comps[c].n;
+        comps[c].n = 0;
+    }
+    for (int v = 0; v < n; v++) {
+        Componente *c = &comps[id_comp[v]];
+        indice_local[v] = c->n;
+        c->vertices[c->n++] = v;
+    }
+
+    // Coloração gulosa na ordem inversa do k-core: no máximo (degeneração + 1) cores
+    for (int v = 0; v < n; v++) cores[v] = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        int v = ordem[i];
+        cores[v] = corGulosa(g, v, n + 1, cores, marca, v + 1);
+        Componente *c = &comps[id_comp[v]];
+        if (cores[v] > c->limite_superior) c->limite_superior = cores[v];
+        if (grauVertice(g, v) > 0) c->tem_aresta = true;
+    }
+
+    // 22ª ALTERAÇÃO: em grafo denso, DSatur/RLF com matriz de bits costuma gastar menos cores.
+    // As cores de cada componente são renumeradas 1, 2, ... (as classes do RLF cruzam componentes).
+    int *cores_bits = malloc((size_t)n * sizeof(int));
+    int *nova_cor = calloc((size_t)n + 2, sizeof(int));
+    if (cores_bits && nova_cor && colorirDensoBits(g, cores_bits) > 0) {
+        for (int c = 0; c < num_comps; c++) {
+            Componente *comp = &comps[c];
+            int usadas = 0;
+            for (int i = 0; i < comp->n; i++) {
+                int cor = cores_bits[comp->vertices[i]];
+                if (!nova_cor[cor]) nova_cor[cor] = ++usadas;
+            }
+            if (usadas < comp->limite_superior) {
+                comp->limite_superior = usadas;
+                for (int i = 0; i < comp->n; i++) cores[comp->vertices[i]] = nova_cor[cores_bits[comp->vertices[i]]];
+            }
+            for (int i = 0; i < comp->n; i++) nova_cor[cores_bits[comp->vertices[i]]] = 0;
+        }
+    }
+    free(cores_bits);
+    free(nova_cor);
+
+    // Componentes mais difíceis primeiro: assim o K necessário sobe cedo e as fáceis são puladas
+    qsort(comps, (size_t)num_comps, sizeof(Componente), compararComponentes);
+
+    TrabalhoComponentes t;
+    t.g = g;
+    t.comps = comps;
+    t.num_comps = num_comps;
+    t.indice_local = indice_local;
+    t.cores = cores;
+    t.k_fixo = k_fixo;
+    t.proxima = 0;
+    t.resultado = 1;
+    t.controle = controle_atual;
+    t.maior_k = 1;
+    int para_sat = 0;
+    for (int c = 0; c < num_comps; c++) {
+        if (comps[c].tem_aresta) t.maior_k = 2;
+    }
+
+    // 23ª ALTERAÇÃO: a clique máxima é o ponto de partida do laço de K (procurada uma vez só:
+    // o modo em lote já a tem para os limites da linha de resumo)
+    const char *env_clique = getenv("GCP_PRAZO_CLIQUE");
+    bool omega_exata = false;
+    int omega = omega_conhecido > 0 ? omega_conhecido
+                                    : cliqueMaxima(g, env_clique ? atof(env_clique) : PRAZO_CLIQUE_PADRAO, &omega_exata);
+    if (omega > t.maior_k) t.maior_k = omega;
+    if (t.controle) maximoAtomico(&t.controle->limite_inferior, t.maior_k);
+    if (mostrar_detalhes && omega_conhecido <= 0 && omega > 2) {
+        printf("Clique %s: %d vértices (nenhuma coloração usa menos cores).\n",
+               omega_exata ? "máxima" : "achada no prazo", omega);
+    }
+    if (k_fixo && omega > k_fixo) {
+        resultado = 0;
+        goto fim;
+    }
+    for (int c = 0; c < num_comps; c++) {
+        if (comps[c].limite_superior > (k_fixo ? k_fixo : t.maior_k)) para_sat++;
+    }
+
+    int num_threads = numeroThreads();
+    if (num_threads > para_sat) num_threads = para_sat > 0 ? para_sat : 1;
+    t.detalhar = para_sat == 1 && mostrar_detalhes;
+    if (num_comps > 1 && mostrar_detalhes) {
+        printf("Grafo com %d componentes conexas; %d vão para o SAT (%d thread%s).\n",
+               num_comps, para_sat, num_threads, num_threads > 1 ? "s" : "");
+    }
+
+    bool detalhes_antes = mostrar_detalhes;
+    if (num_threads > 1) mostrar_detalhes = false;  // Evita mensagens embaralhadas entre threads
+
+    if (num_threads == 1) {
+        trabalhadorComponentes(&t);
+    } else {
+        pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, 64 << 20);  // SAT() é recursivo: pilha folgada
+        int criadas = 0;
+        for (int i = 0; threads && i < num_threads; i++) {
+            if (pthread_create(&threads[i], &attr, trabalhadorComponentes, &t) == 0) criadas++;
+        }
+        if (criadas == 0) trabalhadorComponentes(&t);  // Sem threads: resolve aqui mesmo
+        for (int i = 0; i < criadas; i++) pthread_join(threads[i], NULL);
+        pthread_attr_destroy(&attr);
+        free(threads);
+    }
+    mostrar_detalhes = detalhes_antes;
+
+    resultado = t.resultado;
+    if (resultado < 0 && t.controle && t.controle->esgotado) {
+        // 18ª ALTERAÇÃO: limite esgotado. cores continua válida (gulosa nas componentes que não
+        // terminaram) e é a melhor coloração até aqui; maior_k é o limite inferior provado
+        maximoAtomico(&t.controle->limite_inferior, t.maior_k);
+    }
+    if (resultado == 1 || (resultado < 0 && t.controle && t.controle->esgotado)) {
+        for (int v = 0; v < n; v++) {
+            if (cores[v] > *k_usado) *k_usado = cores[v];
+        }
+    }
+
+fim:
+    free(pai);
+    free(tamanho);
+    free(id_comp);
+    free(vertices);
+    free(indice_local);
+    free(nucleo);
+    free(ordem);
+    free(marca);
+    free(comps);
+    return resultado;
+}
+
+// 12ª ALTERAÇÃO: redução por vértices dominados e gêmeos
+//
+// Se u e w não são vizinhos e N(u) ⊆ N(w), u pode sempre repetir a cor de w: nenhum vizinho
+// de u pode ter a cor de w. Então u sai do grafo e, depois de resolver, volta com a cor de w.
+// Gêmeos falsos (N(u) = N(w)) são o caso mais comum e saem primeiro, agrupados por hash.
+// Gêmeos verdadeiros (N[u] = N[w], vizinhos entre si) precisam de cores diferentes e por isso
+// não podem ser retirados sem mudar o número cromático; eles são só contados.
+
+// Vértices retirados pela redução, na ordem de remoção, e quem os domina
+typedef struct ReducaoDominados {
+    int *removidos;         // Vértices retirados (numeração do grafo original)
+    int *dominador;         // dominador[i]: vértice cuja cor removidos[i] repete
+    int num_removidos;
+    int num_gemeos_falsos;  // Quantos dos removidos eram gêmeos falsos
+    int pares_gemeos_verdadeiros;
+    int *novo_indice;       // Índice no grafo reduzido (-1 se removido)
+} ReducaoDominados;
+
+void liberarReducaoDominados(ReducaoDominados *r);
+
+// Hash da vizinhança original de v (a lista CSR inteira, sem olhar quem já foi removido: os gêmeos
+// comparam as listas originais); 'extra' entra junto (vizinhança fechada). Independe da ordem.
+static uint64_t hashVizinhanca(Grafo *g, int v, int extra)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (size_t j = g->adj_inicio[v]; j < g->adj_inicio[v + 1]; j++) {
+        uint64_t x = (uint64_t)g->adj_vizinhos[j] + 1;
+        x *= 0xff51afd7ed558ccdULL;
+        h += x ^ (x >> 31);  // Soma de termos misturados: independe da ordem
+    }
+    if (extra >= 0) {
+        uint64_t x = (uint64_t)extra + 1;
+        x *= 0xff51afd7ed558ccdULL;
+        h += x ^ (x >> 31);
+    }
+    return h;
+}
+
+// Vetor auxiliar para ordenar vértices por hash
+typedef struct {
+    uint64_t hash;
+    int v;
+} HashVertice;
+
+static int compararHashVertice(const void *a, const void *b)
+{
+    const HashVertice *x = a, *y = b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    return x->v - y->v;
+}
+
+// w está na lista (ordenada) de vizinhos de v? Busca binária na adjacência CSR
+static bool saoVizinhos(Grafo *g, int v, int w)
+{
+    size_t ini = g->adj_inicio[v], fim = g->adj_inicio[v + 1];
+    while (ini < fim) {
+        size_t meio = ini + (fim - ini) / 2;
+        if (g->adj_vizinhos[meio] < w) ini = meio + 1;
+        else fim = meio;
+    }
+    return ini < g->adj_inicio[v + 1] && g->adj_vizinhos[ini] == w;
+}
+
+// N(u) ⊆ N(w), olhando só os vértices ainda não removidos?
+static bool vizinhancaContida(Grafo *g, int u, int w, const bool *removido)
+{
+    for (size_t j = g->adj_inicio[u]; j < g->adj_inicio[u + 1]; j++) {
+        int y = g->adj_vizinhos[j];
+        if (!removido[y] && !saoVizinhos(g, w, y)) return false;
+    }
+    return true;
+}
+
+/**
+ * Retira gêmeos falsos e vértices dominados, montando o grafo reduzido
+ * @param g Grafo original
+ * @param reduzido Saída: grafo sem os vértices retirados (renumerado)
+ * @param r Saída: o que foi retirado e por quem (para restaurarDominados)
+ * @return false se faltou memória
+ */
+bool reduzirDominados(Grafo *g, Grafo *reduzido, ReducaoDominados *r)
+{
+    int n = g->n_vertices;
+    memset(r, 0, sizeof(*r));
+    iniciarGrafo(reduzido);
+
+    bool *removido = calloc((size_t)n + 1, sizeof(bool));
+    int *grau = malloc(((size_t)n + 1) * sizeof(int));        // Grau atual (sem os removidos)
+    HashVertice *hv = malloc(((size_t)n + 1) * sizeof(HashVertice));
+    r->removidos = malloc(((size_t)n + 1) * sizeof(int));
+    r->dominador = malloc(((size_t)n + 1) * sizeof(int));
+    r->novo_indice = malloc(((size_t)n + 1) * sizeof(int));
+    if (!removido || !grau || !hv || !r->removidos || !r->dominador || !r->novo_indice) {
+        free(removido);
+        free(grau);
+        free(hv);
+        liberarReducaoDominados(r);
+        return false;
+    }
+    for (int v = 0; v < n; v++) grau[v] = grauVertice(g, v);
+
+    // === Gêmeos falsos: vizinhanças abertas iguais (nunca são vizinhos entre si) ===
+    for (int v = 0; v < n; v++) {
+        hv[v].hash = hashVizinhanca(g, v, -1) ^ ((uint64_t)grau[v] << 48);
+        hv[v].v = v;
+    }
+    qsort(hv, (size_t)n, sizeof(HashVertice), compararHashVertice);
+    for (int i = 0; i < n; ) {
+        int j = i + 1;
+        while (j < n && hv[j].hash == hv[i].hash) j++;
+        // Dentro do grupo de mesmo hash, confere as listas de verdade
+        for (int a = i; a < j; a++) {
+            int w = hv[a].v;
+            if (removido[w] || grau[w] == 0) continue;  // Isolados já saem pelo k-core
+            for (int b = a + 1; b < j; b++) {
+                int u = hv[b].v;
+                if (removido[u] || grau[u] != grau[w]) continue;
+                if (memcmp(g->adj_vizinhos + g->adj_inicio[u], g->adj_vizinhos + g->adj_inicio[w],
+                           (size_t)grau[u] * sizeof(int)) != 0) continue;
+                removido[u] = true;
+                r->removidos[r->num_removidos] = u;
+                r->dominador[r->num_removidos++] = w;
+                r->num_gemeos_falsos++;
+            }
+        }
+        i = j;
+    }
+    for (int v = 0; v < n; v++) {
+        if (!removido[v]) continue;
+        for (size_t j = g->adj_inicio[v]; j < g->adj_inicio[v + 1]; j++) grau[g->adj_vizinhos[j]]--;
+    }
+
+    // === Gêmeos verdadeiros: vizinhanças fechadas iguais (só contados) ===
+    for (int v = 0; v < n; v++) {
+        hv[v].hash = hashVizinhanca(g, v, v);
+        hv[v].v = v;
+    }
+    qsort(hv, (size_t)n, sizeof(HashVertice), compararHashVertice);
+    for (int i = 0; i + 1 < n; i++) {
+        int u = hv[i].v, w = hv[i + 1].v;
+        if (hv[i].hash == hv[i + 1].hash && grauVertice(g, u) == grauVertice(g, w) && grauVertice(g, u) > 0 &&
+            saoVizinhos(g, u, w)) {
+            r->pares_gemeos_verdadeiros++;
+        }
+    }
+
+    // === Dominação: N(u) ⊆ N(w), com u e w não vizinhos ===
+    // Todo candidato w divide com u o vizinho x de menor grau; o esforço total é limitado.
+    long long esforco = 20LL * (long long)(g->adj_inicio[n]) + 1000000;
+    bool mudou = true;
+    while (mudou && esforco > 0) {
+        mudou = false;
+        for (int u = 0; u < n && esforco > 0; u++) {
+            if (removido[u] || grau[u] == 0) continue;
+
+            int x = -1;
+            for (size_t j = g->adj_inicio[u]; j < g->adj_inicio[u + 1]; j++) {
+                int y = g->adj_vizinhos[j];
+                if (!removido[y] && (x < 0 || grau[y] < grau[x])) x = y;
+            }
+
+            for (size_t j = g->adj_inicio[x]; j < g->adj_inicio[x + 1] && esforco > 0; j++) {
+                int w = g->adj_vizinhos[j];
+                if (w == u || removido[w] || grau[w] < grau[u]) continue;
+                esforco -= grau[u];
+                if (saoVizinhos(g, u, w) || !vizinhancaContida(g, u, w, removido)) continue;
+
+                removido[u] = true;
+                r->removidos[r->num_removidos] = u;
+                r->dominador[r->num_removidos++] = w;
+                for (size_t i = g->adj_inicio[u]; i < g->adj_inicio[u + 1]; i++) grau[g->adj_vizinhos[i]]--;
+                mudou = true;
+                break;
+            }
+        }
+    }
+
+    int mantidos = 0;
+    for (int v = 0; v < n; v++) r->novo_indice[v] = removido[v] ? -1 : mantidos++;
+
+    free(removido);
+    free(grau);
+    free(hv);
+
+    if (!subgrafoInduzido(g, r->novo_indice, mantidos, reduzido)) {
+        liberarReducaoDominados(r);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Devolve as cores ao grafo original: cada vértice retirado repete a cor do seu dominador,
+ * na ordem inversa da remoção (o dominador sempre já tem cor quando chega a vez dele)
+ * @param r Redução feita por reduzirDominados
+ * @param n Vértices do grafo original
+ * @param cores_reduzido Cores do grafo reduzido
+ * @param cores Saída: cores do grafo original
+ */
+void restaurarDominados(ReducaoDominados *r, int n, const int *cores_reduzido, int *cores)
+{
+    for (int v = 0; v < n; v++) {
+        cores[v] = r->novo_indice[v] >= 0 ? cores_reduzido[r->novo_indice[v]] : 0;
+    }
+    for (int i = r->num_removidos - 1; i >= 0; i--) {
+        cores[r->removidos[i]] = cores[r->dominador[i]];
+    }
+}
+
+void liberarReducaoDominados(ReducaoDominados *r)
+{
+    free(r->removidos);
+    free(r->dominador);
+    free(r->novo_indice);
+    memset(r, 0, sizeof(*r));
+}
+
+/**
+ * Colore o grafo completo: redução por dominação, componentes em paralelo (cada uma com
+ * k-core + SAT) e restauração dos vértices retirados
+ * @param g Grafo
+ * @param k_fixo K pedido (teste único) ou 0 para achar o menor K (teste iterativo)
+ * @param omega_conhecido Clique de g já achada por quem chama (0 = procurar). A redução por
+ *        dominação não muda a clique máxima: o vértice dominado troca de lugar com o dominante.
+ * @param cores Saída: cores[v] para cada vértice
+ * @param k_usado Saída: quantidade de cores usada
+ * @return 1 se colorível, 0 se não colorível com k_fixo, -1 em erro
+ */
+int colorirGrafoComLimite(Grafo *g, int k_fixo, int omega_conhecido, int *cores, int *k_usado)
+{
+    *k_usado = 0;
+    if (g->num_lacos > 0) return 0;
+
+    Grafo reduzido;
+    ReducaoDominados r;
+    if (!reduzirDominados(g, &reduzido, &r)) {
+        printf("Erro: memória insuficiente na redução por dominação.\n");
+        return -1;
+    }
+    if (mostrar_detalhes && (r.num_removidos > 0 || r.pares_gemeos_verdadeiros > 0)) {
+        printf("Redução por dominação: %d vértice%s retirado%s (%d gêmeos falsos); %d par%s de gêmeos verdadeiros.\n",
+               r.num_removidos, r.num_removidos == 1 ? "" : "s", r.num_removidos == 1 ? "" : "s",
+               r.num_gemeos_falsos, r.pares_gemeos_verdadeiros, r.pares_gemeos_verdadeiros == 1 ? "" : "es");
+    }
+
+    int *cores_reduzido = malloc(((size_t)reduzido.n_vertices + 1) * sizeof(int));
+    int resultado = cores_reduzido ? resolverComponentes(&reduzido, k_fixo, omega_conhecido, cores_reduzido, k_usado) : -1;
+    bool parcial = resultado < 0 && controle_atual && controle_atual->esgotado;  // 18ª: melhor até aqui
+    if (resultado == 1 || parcial) restaurarDominados(&r, g->n_vertices, cores_reduzido, cores);
+
+    free(cores_reduzido);
+    liberarGrafo(&reduzido);
+    liberarReducaoDominados(&r);
+    return resultado;
+}
+
+// colorirGrafoComLimite procurando a clique máxima por conta própria
+int colorirGrafo(Grafo *g, int k_fixo, int *cores, int *k_usado)
+{
+    return colorirGrafoComLimite(g, k_fixo, 0, cores, k_usado);
+}
+
+// 13ª ALTERAÇÃO: modo incremental (grafo que muda aos poucos)
+//
+// O grafo e a coloração ficam na memória e cada comando de aresta só mexe na vizinhança do
+// conflito: primeiro tenta trocar a cor de uma das pontas, depois resolve pelo SAT uma região
+// em volta (raio crescente) com as cores da borda fixas. Só quando nem a componente inteira
+// cabe em K cores é que o grafo todo é resolvido de novo (aí o número de cores muda).
+
+#define MAX_REGIAO_INCREMENTAL 24  // Maior região resolvida localmente pelo SAT
+
+// Lista de vizinhos que cresce (o CSR é fixo e não serve para inserções)
+typedef struct {
+    int *v;
+    int n;
+    int cap;
+} ListaVizinhos;
+
+// Grafo dinâmico + coloração atual
+typedef struct {
+    int n;
+    ListaVizinhos *adj;
+    int *cores;
+    int k;                  // Cores disponíveis (a coloração atual usa no máximo k)
+} GrafoIncremental;
+
+static int posicaoVizinho(ListaVizinhos *l, int w)
+{
+    for (int i = 0; i < l->n; i++) {
+        if (l->v[i] == w) return i;
+    }
+    return -1;
+}
+
+static bool incluirVizinho(ListaVizinhos *l, int w)
+{
+    if (l->n == l->cap) {
+        int nova = l->cap ? 2 * l->cap : 4;
+        int *novo = realloc(l->v, (size_t)nova * sizeof(int));
+        if (!novo) return false;
+        l->v = novo;
+        l->cap = nova;
+    }
+    l->v[l->n++] = w;
+    return true;
+}
+
+static void retirarVizinho(ListaVizinhos *l, int w)
+{
+    int i = posicaoVizinho(l, w);
+    if (i >= 0) l->v[i] = l->v[--l->n];
+}
+
+// Monta um Grafo (com CSR) a partir das listas dinâmicas, para a resolução completa
+static bool grafoDasListas(GrafoIncremental *gi, Grafo *g)
+{
+    iniciarGrafo(g);
+    g->n_vertices = gi->n;
+    for (int u = 0; u < gi->n; u++) {
+        for (int i = 0; i < gi->adj[u].n; i++) {
+            int v = gi->adj[u].v[i];
+            if (v > u && !adicionarAresta(g, u, v)) {
+                liberarGrafo(g);
+                return false;
+            }
+        }
+    }
+    if (!construirAdjacencia(g)) {
+        liberarGrafo(g);
+        return false;
+    }
+    return true;
+}
+
+// Resolve o grafo inteiro de novo; k_fixo = 0 acha o menor K
+static int resolverTudo(GrafoIncremental *gi, int k_fixo)
+{
+    Grafo g;
+    if (!grafoDasListas(gi, &g)) return -1;
+    int k_usado;
+    bool detalhes_antes = mostrar_detalhes;
+    mostrar_detalhes = false;
+    int r = colorirGrafo(&g, k_fixo, gi->cores, &k_usado);
+    mostrar_detalhes = detalhes_antes;
+    if (r == 1) gi->k = k_fixo ? (k_usado > k_fixo ? k_usado : k_fixo) : k_usado;
+    liberarGrafo(&g);
+    return r;
+}
+
+// Menor cor em 1..k livre entre os vizinhos de v (0 se nenhuma)
+static int corLivre(GrafoIncremental *gi, int v, int *marca, int selo)
+{
+    for (int i = 0; i < gi->adj[v].n; i++) {
+        int c = gi->cores[gi->adj[v].v[i]];
+        if (c >= 1 && c <= gi->k) marca[c] = selo;
+    }
+    for (int c = 1; c <= gi->k; c++) {
+        if (marca[c] != selo) return c;
+    }
+    return 0;
+}
+
+/**
+ * Recolore só a região (vértices em 'regiao') pelo SAT, com as cores de fora fixas:
+ * cada vértice da região só pode usar cores que nenhum vizinho de fora usa.
+ * @return 1 se achou cores para a região (já gravadas em gi->cores), 0 se não há, -1 em erro
+ */
+static int recolorirRegiao(GrafoIncremental *gi, const int *regiao, int tam, int *indice_regiao)
+{
+    int k = gi->k;
+    for (int i = 0; i < tam; i++) indice_regiao[regiao[i]] = i;
+
+    // Conta cláusulas e literais para alocar a arena de uma vez
+    long long num_clausulas = 0, tam_arena = 0;
+    for (int i = 0; i < tam; i++) {
+        int v = regiao[i];
+        num_clausulas += 1 + (long long)k * (k - 1) / 2;
+        tam_arena += (k + 1) + 3LL * k * (k - 1) / 2;
+        for (int j = 0; j < gi->adj[v].n; j++) {
+            int w = gi->adj[v].v[j];
+            if (indice_regiao[w] > i) {
+                num_clausulas += k;
+                tam_arena += 3LL * k;
+            }
+        }
+    }
+
+    Formula *f = malloc(sizeof(Formula));
+    if (!f) return -1;
+    f->num_literais = tam * k;
+    f->num_clausulas = (int)num_clausulas;
+    f->clausulas = alocarRastreado(MEM_CLAUSULAS, (size_t)num_clausulas * sizeof(int*));
+    f->arena = alocarRastreado(MEM_CLAUSULAS, (size_t)tam_arena * sizeof(int));
+    f->mapa = NULL;
+    f->tam_mapa = 0;
+    f->vertices = criarMapaVariaveis(tam, k);  // 28ª ALTERAÇÃO: mesma numeração i*k + c da fórmula do grafo
+    for (int i = 0; f->vertices && i < tam; i++) f->vertices->grau[i] = gi->adj[regiao[i]].n;
+    bool *proibida = calloc((size_t)k + 1, sizeof(bool));
+    if (!f->clausulas || !f->arena || !proibida) {
+        free(proibida);
+        liberarRastreado(f->clausulas);  // Sem arena, liberar_formula liberaria cláusula por cláusula
+        liberarRastreado(f->arena);
+        liberarMapaVariaveis(f->vertices);
+        free(f);
+        return -1;
+    }
+
+    int *p = f->arena;
+    int c_atual = 0;
+    for (int i = 0; i < tam; i++) {
+        int v = regiao[i];
+
+        // Regra 1 só com as cores que os vizinhos de fora da região deixam livres
+        for (int c = 1; c <= k; c++) proibida[c] = false;
+        for (int j = 0; j < gi->adj[v].n; j++) {
+            int w = gi->adj[v].v[j];
+            if (indice_regiao[w] < 0 && gi->cores[w] >= 1 && gi->cores[w] <= k) proibida[gi->cores[w]] = true;
+        }
+        f->clausulas[c_atual++] = p;
+        for (int c = 1; c <= k; c++) {
+            if (!proibida[c]) *p++ = i * k + c;
+        }
+        *p++ = 0;  // Sem cor livre vira cláusula vazia: região sem solução
+
+        // Regra 2: no máximo uma cor
+        for (int c1 = 1; c1 <= k; c1++) {
+            for (int c2 = c1 + 1; c2 <= k; c2++) {
+                f->clausulas[c_atual++] = p;
+                *p++ = -(i * k + c1);
+                *p++ = -(i * k + c2);
+                *p++ = 0;
+            }
+        }
+
+        // Regra 3: arestas dentro da região
+        for (int j = 0; j < gi->adj[v].n; j++) {
+            int w = gi->adj[v].v[j];
+            int iw = indice_regiao[w];
+            if (iw <= i) continue;
+            for (int c = 1; c <= k; c++) {
+                f->clausulas[c_atual++] = p;
+                *p++ = -(i * k + c);
+                *p++ = -(iw * k + c);
+                *p++ = 0;
+            }
+        }
+    }
+    free(proibida);
+
+    int *interpretacao = alocarRastreadoZerado(MEM_INTERPRETACAO, ((size_t)f->num_literais + 1) * sizeof(int));
+    BinaryTree *raiz = alocarRastreado(MEM_ARVORE, sizeof(BinaryTree));
+    int resultado = -1;
+    if (interpretacao && raiz) {
+        raiz->variavel = 0;
+        raiz->valor = 0;
+        raiz->esquerda = raiz->direita = NULL;
+        double inicio = iniciarFase(FASE_SAT);
+        resultado = resolverFormula(f, interpretacao, raiz);  // 25ª ALTERAÇÃO: CDCL, ou DPLL com GCP_SAT=dpll
+        registrarFase(FASE_SAT, inicio);
+        descarregarEstatisticas();
+        if (resultado == 0 && controle_atual && __atomic_load_n(&controle_atual->esgotado, __ATOMIC_RELAXED)) {
+            resultado = -1;  // Teto de memória: não é prova
+        }
+        for (int i = 0; resultado == 1 && i < tam; i++) {
+            for (int c = 1; c <= k; c++) {
+                if (interpretacao[i * k + c] == 1) {
+                    gi->cores[regiao[i]] = c;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < tam; i++) indice_regiao[regiao[i]] = -1;
+    liberarRastreado(interpretacao);
+    liberar_arvore(raiz);
+    liberar_formula(f);
+    return resultado;
+}
+
+/**
+ * Conserta o conflito na aresta (u, v): troca de cor de uma ponta, depois SAT em regiões de
+ * raio crescente em volta da aresta e, por último, resolução completa.
+ * @return Quantos vértices mudaram de cor (ou -1 em erro)
+ */
+static int repararConflito(GrafoIncremental *gi, int u, int v, int *marca, int *selo, int *indice_regiao)
+{
+    // 1) Basta trocar a cor de uma das pontas?
+    int c = corLivre(gi, v, marca, ++*selo);
+    if (c) { gi->cores[v] = c; return 1; }
+    c = corLivre(gi, u, marca, ++*selo);
+    if (c) { gi->cores[u] = c; return 1; }
+
+    // 2) SAT em uma região em volta da aresta (busca em largura por camadas)
+    int *regiao = malloc((size_t)gi->n * sizeof(int));
+    int *antes = malloc((size_t)MAX_REGIAO_INCREMENTAL * sizeof(int));
+    if (!regiao || !antes) {
+        free(regiao);
+        free(antes);
+        return -1;
+    }
+    int tam = 0;
+    regiao[tam++] = u;
+    regiao[tam++] = v;
+    indice_regiao[u] = indice_regiao[v] = 0;  // Marca como visitados durante a busca
+    int camada_ini = 0;
+    bool componente_inteira = false;
+    int resultado = 0;
+
+    while (tam <= MAX_REGIAO_INCREMENTAL) {
+        // Tenta resolver a região atual
+        for (int i = 0; i < tam; i++) {
+            indice_regiao[regiao[i]] = -1;
+            antes[i] = gi->cores[regiao[i]];
+        }
+        int r = recolorirRegiao(gi, regiao, tam, indice_regiao);
+        if (r < 0) { resultado = -1; break; }
+        if (r == 1) {
+            for (int i = 0; i < tam; i++) resultado += gi->cores[regiao[i]] != antes[i];
+            break;
+        }
+        for (int i = 0; i < tam; i++) indice_regiao[regiao[i]] = 0;
+
+        // Cresce uma camada
+        int camada_fim = tam;
+        for (int i = camada_ini; i < camada_fim && tam < gi->n; i++) {
+            int x = regiao[i];
+            for (int j = 0; j < gi->adj[x].n; j++) {
+                int y = gi->adj[x].v[j];
+                if (indice_regiao[y] < 0) {
+                    indice_regiao[y] = 0;
+                    regiao[tam++] = y;
+                }
+            }
+        }
+        if (tam == camada_fim) { componente_inteira = true; break; }  // Não há mais o que crescer
+        camada_ini = camada_fim;
+    }
+    for (int i = 0; i < tam; i++) indice_regiao[regiao[i]] = -1;
+    free(regiao);
+    free(antes);
+    if (resultado != 0) return resultado;
+
+    // 3) Resolução completa: com o mesmo K se a região só ficou grande demais; se a componente
+    //    inteira não cabe em K cores, o número de cores precisa mudar
+    int r = componente_inteira ? 0 : resolverTudo(gi, gi->k);
+    if (r == 0) {
+        printf("Número de cores precisa mudar: resolvendo o grafo inteiro.\n");
+        r = resolverTudo(gi, 0);
+    }
+    return r < 0 ? -1 : gi->n;
+}
+
+/**
+ * Modo incremental: lê comandos da entrada padrão, um por linha
+ *   + u v   insere a aresta u-v        - u v   remove a aresta u-v
+ *   k       mostra o K atual           c       mostra a coloração
+ *   o       resolve tudo de novo (tenta diminuir K)
+ *   q       sai
+ * Os vértices são numerados a partir de 1, como na coloração impressa.
+ */
+void modoIncremental(Grafo *g)
+{
+    GrafoIncremental gi;
+    gi.n = g->n_vertices;
+    gi.k = 0;
+    gi.adj = calloc((size_t)gi.n + 1, sizeof(ListaVizinhos));
+    gi.cores = malloc(((size_t)gi.n + 1) * sizeof(int));
+    int *indice_regiao = malloc(((size_t)gi.n + 1) * sizeof(int));
+    int *marca = NULL;
+    int selo = 0;
+    bool ok = gi.adj && gi.cores && indice_regiao;
+    ControleTrabalho controle;  // Sem limites: só registra as recusas do teto de memória de cada comando
+    memset(&controle, 0, sizeof(controle));
+    controle_atual = &controle;
+
+    for (int u = 0; ok && u < gi.n; u++) {
+        indice_regiao[u] = -1;
+        for (size_t j = g->adj_inicio[u]; ok && j < g->adj_inicio[u + 1]; j++) {
+            ok = incluirVizinho(&gi.adj[u], g->adj_vizinhos[j]);
+        }
+    }
+    if (ok && resolverTudo(&gi, 0) != 1) ok = false;
+    if (!ok) {
+        printf("Erro ao preparar o modo incremental.\n");
+    } else {
+        printf("Coloração inicial com %d cor%s.\n", gi.k, gi.k > 1 ? "es" : "");
+        printf("Comandos: + u v | - u v | k | c | o | q\n");
+    }
+
+    char linha[256];
+    while (ok && fgets(linha, sizeof(linha), stdin)) {
+        char cmd;
+        int u, v;
+        if (sscanf(linha, " %c", &cmd) != 1) continue;
+        if (cmd == 'q') break;
+        memset(&controle, 0, sizeof(controle));
+
+        marca = realloc(marca, ((size_t)gi.k + 2) * sizeof(int));  // K pode ter mudado
+        if (!marca) break;
+        for (int c = 0; c <= gi.k + 1; c++) marca[c] = 0;
+        selo = 0;
+
+        if (cmd == 'k') {
+            printf("K = %d\n", gi.k);
+        } else if (cmd == 'c') {
+            for (int x = 0; x < gi.n; x++) printf("Vértice %d --> cor %d\n", x + 1, gi.cores[x]);
+        } else if (cmd == 'o') {
+            int k_antes = gi.k;
+            if (resolverTudo(&gi, 0) != 1) break;
+            printf("Resolvido de novo: K = %d (antes %d).\n", gi.k, k_antes);
+        } else if ((cmd == '+' || cmd == '-') && sscanf(linha, " %*c %d %d", &u, &v) == 2) {
+            if (u < 1 || v < 1 || u > gi.n || v > gi.n || u == v) {
+                printf("Erro: aresta %d-%d inválida (vértices de 1 a %d, sem laço).\n", u, v, gi.n);
+                continue;
+            }
+            u--;
+            v--;
+            bool existe = posicaoVizinho(&gi.adj[u], v) >= 0;
+
+            if (cmd == '-') {
+                if (existe) {
+                    retirarVizinho(&gi.adj[u], v);
+                    retirarVizinho(&gi.adj[v], u);
+                    // Sem a aresta, as pontas podem descer para uma cor menor
+                    int mudou = 0;
+                    int ends[2] = { u, v };
+                    for (int e = 0; e < 2; e++) {
+                        int x = ends[e];
+                        int c = corLivre(&gi, x, marca, ++selo);
+                        if (c && c < gi.cores[x]) { gi.cores[x] = c; mudou++; }
+                    }
+                    // Se ninguém mais usa a maior cor, K diminui sem resolver nada
+                    bool usada = false;
+                    for (int x = 0; x < gi.n && !usada; x++) usada = gi.cores[x] == gi.k;
+                    if (!usada && gi.k > 1) gi.k--;
+                    printf("Aresta %d-%d removida; %d vértice%s recolorido%s; K = %d\n",
+                           u + 1, v + 1, mudou, mudou == 1 ? "" : "s", mudou == 1 ? "" : "s", gi.k);
+                } else {
+                    printf("Aresta %d-%d não existe.\n", u + 1, v + 1);
+                }
+                continue;
+            }
+
+            if (existe) {
+                printf("Aresta %d-%d já existe.\n", u + 1, v + 1);
+                continue;
+            }
+            if (!incluirVizinho(&gi.adj[u], v) || !incluirVizinho(&gi.adj[v], u)) break;
+
+            int mudou = 0;
+            if (gi.cores[u] == gi.cores[v]) {
+                mudou = repararConflito(&gi, u, v, marca, &selo, indice_regiao);
+                if (mudou < 0) break;
+            }
+            printf("Aresta %d-%d inserida; %d vértice%s recolorido%s; K = %d\n",
+                   u + 1, v + 1, mudou, mudou == 1 ? "" : "s", mudou == 1 ? "" : "s", gi.k);
+        } else {
+            printf("Comando desconhecido. Use: + u v | - u v | k | c | o | q\n");
+        }
+    }
+
+    controle_atual = NULL;
+    for (int u = 0; gi.adj && u < gi.n; u++) free(gi.adj[u].v);
+    free(gi.adj);
+    free(gi.cores);
+    free(indice_regiao);
+    free(marca);
+}
+
+// 14ª ALTERAÇÃO: modo servidor (socket Unix + fila de trabalhos)
+//
+// "GCP_5 --servidor [caminho]" fica rodando e recebe trabalhos por um socket Unix, um por
+// linha de texto. Os trabalhos vão para uma fila por prioridade atendida por um grupo fixo
+// de threads; cada resposta volta pela mesma conexão, uma linha por evento, com o id do
+// trabalho na frente. Comandos:
+//   grafo <arquivo> [k=K] [prazo=S] [prioridade=P]   colore (K = 0 acha o menor)
+//   cnf <arquivo> [prazo=S] [prioridade=P]            resolve um CNF DIMACS
+//   encerrar                                         termina o que está na fila e sai
+// Respostas: "<id> aceito", "<id> iniciado", "<id> cor <v> <c>" (uma por vértice) ou
+// "<id> v <literais> 0", e por fim "<id> fim <SAT|UNSAT|TEMPO_ESGOTADO|ERRO> ...".
+// Limites de conflitos e memória vêm de GCP_MAX_CONFLITOS e GCP_MAX_MEMORIA_MB (18ª ALTERAÇÃO);
+// quando um limite acaba, a melhor coloração achada vem nas linhas "cor" antes do "fim".
+
+#define CAMINHO_SOCKET_PADRAO "/tmp/gcp5.sock"
+#define MAX_LINHA_SERVIDOR 4096
+
+// Uma conexão de cliente: fica aberta até o cliente fechar e todos os trabalhos dela acabarem
+typedef struct {
+    int fd;
+    pthread_mutex_t trava;       // Linhas de trabalhos diferentes não se misturam
+    pthread_cond_t terminou;
+    int pendentes;               // Trabalhos ainda na fila ou rodando
+    bool perdida;                // O cliente foi embora: trabalhos na fila são descartados
+} Conexao;
+
+typedef enum { TRABALHO_GRAFO, TRABALHO_CNF } TipoTrabalho;
+
+typedef struct {
+    long id;
+    TipoTrabalho tipo;
+    char *arquivo;
+    int k;                       // Só para grafo: 0 acha o menor K
+    double prazo;                // Segundos de relógio a partir do início; 0 = sem prazo
+    int prioridade;              // Maior sai primeiro; empate sai na ordem de chegada
+    Conexao *conexao;
+} Trabalho;
+
+// Fila de prioridade (heap binário) compartilhada pelas threads de trabalho
+typedef struct {
+    Trabalho **heap;
+    int n;
+    int cap;
+    bool encerrando;
+    pthread_mutex_t trava;
+    pthread_cond_t tem_trabalho;
+} FilaTrabalhos;
+
+static FilaTrabalhos fila_servidor = { NULL, 0, 0, false, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+static long proximo_id_trabalho = 1;
+static int socket_escuta = -1;
+
+static bool vemAntes(const Trabalho *a, const Trabalho *b)
+{
+    return a->prioridade != b->prioridade ? a->prioridade > b->prioridade : a->id < b->id;
+}
+
+static bool enfileirarTrabalho(FilaTrabalhos *q, Trabalho *t)
+{
+    pthread_mutex_lock(&q->trava);
+    if (q->n == q->cap) {
+        int nova = q->cap ? 2 * q->cap : 64;
+        Trabalho **novo = realloc(q->heap, (size_t)nova * sizeof(Trabalho*));
+        if (!novo) {
+            pthread_mutex_unlock(&q->trava);
+            return false;
+        }
+        q->heap = novo;
+        q->cap = nova;
+    }
+    int i = q->n++;
+    while (i > 0 && vemAntes(t, q->heap[(i - 1) / 2])) {
+        q->heap[i] = q->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    q->heap[i] = t;
+    pthread_cond_signal(&q->tem_trabalho);
+    pthread_mutex_unlock(&q->trava);
+    return true;
+}
+
+// Espera o próximo trabalho; NULL quando a fila está vazia e o servidor encerrando
+static Trabalho *desenfileirarTrabalho(FilaTrabalhos *q)
+{
+    pthread_mutex_lock(&q->trava);
+    while (q->n == 0 && !q->encerrando) pthread_cond_wait(&q->tem_trabalho, &q->trava);
+    Trabalho *topo = NULL;
+    if (q->n > 0) {
+        topo = q->heap[0];
+        Trabalho *ultimo = q->heap[--q->n];
+        int i = 0;
+        for (;;) {
+            int f = 2 * i + 1;
+            if (f >= q->n) break;
+            if (f + 1 < q->n && vemAntes(q->heap[f + 1], q->heap[f])) f++;
+            if (!vemAntes(q->heap[f], ultimo)) break;
+            q->heap[i] = q->heap[f];
+            i = f;
+        }
+        if (q->n > 0) q->heap[i] = ultimo;
+    }
+    pthread_mutex_unlock(&q->trava);
+    return topo;
+}
+
+// Envia uma linha inteira ao cliente (ou nada, se ele já foi embora)
+static void enviarLinha(Conexao *c, const char *formato, ...) __attribute__((format(printf, 2, 3)));
+static void enviarLinha(Conexao *c, const char *formato, ...)
+{
+    char linha[MAX_LINHA_SERVIDOR];
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(linha, sizeof(linha) - 1, formato, args);
+    va_end(args);
+    if (n < 0) return;
+    if (n > (int)sizeof(linha) - 2) n = (int)sizeof(linha) - 2;
+    linha[n++] = '\n';
+
+    pthread_mutex_lock(&c->trava);
+    for (int enviado = 0; !c->perdida && enviado < n; ) {
+        ssize_t r = send(c->fd, linha + enviado, (size_t)(n - enviado), MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) c->perdida = true;
+        else enviado += (int)r;
+    }
+    pthread_mutex_unlock(&c->trava);
+}
+
+static void concluirTrabalho(Trabalho *t)
+{
+    Conexao *c = t->conexao;
+    pthread_mutex_lock(&c->trava);
+    c->pendentes--;
+    pthread_cond_signal(&c->terminou);
+    pthread_mutex_unlock(&c->trava);
+    free(t->arquivo);
+    free(t);
+}
+
+// Motivo de parada em maiúsculas, como os outros status do protocolo (TEMPO_ESGOTADO, ...)
+static const char *nomeLimiteServidor(int motivo)
+{
+    static const char *const nomes[] = { "ERRO", "TEMPO_ESGOTADO", "LIMITE_CONFLITOS", "LIMITE_MEMORIA", "INTERROMPIDO" };
+    return motivo >= LIMITE_TEMPO && motivo <= LIMITE_SINAL ? nomes[motivo] : nomes[0];
+}
+
+static void executarTrabalhoGrafo(Trabalho *t, double inicio)
+{
+    Grafo g;
+    iniciarGrafo(&g);
+    if (!lerGrafo(t->arquivo, &g)) {
+        enviarLinha(t->conexao, "%ld fim ERRO leitura do grafo", t->id);
+        return;
+    }
+    int *cores = malloc(((size_t)g.n_vertices + 1) * sizeof(int));
+    int k_usado = 0;
+    int r = cores ? colorirGrafo(&g, t->k, cores, &k_usado) : -1;
+    double tempo = segundosAgora() - inicio;
+
+    if (r == 1) {
+        for (int v = 0; v < g.n_vertices; v++) enviarLinha(t->conexao, "%ld cor %d %d", t->id, v + 1, cores[v]);
+        enviarLinha(t->conexao, "%ld fim SAT k=%d tempo=%.3f", t->id, k_usado, tempo);
+    } else if (r == 0) {
+        enviarLinha(t->conexao, "%ld fim UNSAT k=%d tempo=%.3f", t->id, t->k, tempo);
+    } else if (controle_atual->esgotado) {
+        // 18ª ALTERAÇÃO: manda a melhor coloração achada e o que ainda está em aberto
+        for (int v = 0; v < g.n_vertices; v++) enviarLinha(t->conexao, "%ld cor %d %d", t->id, v + 1, cores[v]);
+        enviarLinha(t->conexao, "%ld fim %s melhor_k=%d limite_inferior=%d tempo=%.3f", t->id,
+                    nomeLimiteServidor(controle_atual->motivo), k_usado, controle_atual->limite_inferior, tempo);
+    } else {
+        enviarLinha(t->conexao, "%ld fim ERRO memória insuficiente", t->id);
+    }
+    free(cores);
+    liberarGrafo(&g);
+}
+
+static void executarTrabalhoCNF(Trabalho *t, double inicio)
+{
+    char erro[256];
+    Formula *f = lerFormulaDIMACS(t->arquivo, erro, sizeof(erro));
+    if (!f) {
+        enviarLinha(t->conexao, "%ld fim ERRO leitura do CNF: %s", t->id, erro);
         return;
     }
+    int *interpretacao = alocarRastreadoZerado(MEM_INTERPRETACAO, ((size_t)f->num_literais + 1) * sizeof(int));
+    BinaryTree *raiz = alocarRastreado(MEM_ARVORE, sizeof(BinaryTree));
+    if (!interpretacao || !raiz) {
+        enviarLinha(t->conexao, "%ld fim ERRO memória insuficiente", t->id);
+    } else {
+        raiz->variavel = 0;
+        raiz->valor = 0;
+        raiz->esquerda = raiz->direita = NULL;
+        double inicio_sat = iniciarFase(FASE_SAT);
+        int resultado = resolverFormula(f, interpretacao, raiz);  // 25ª ALTERAÇÃO
+        registrarFase(FASE_SAT, inicio_sat);
+        descarregarEstatisticas();
+        double tempo = segundosAgora() - inicio;
+        if (resultado == 1) {
+            // Modelo no estilo DIMACS, em linhas de até ~20 literais
+            char linha[MAX_LINHA_SERVIDOR];
+            int usado = 0;
+            for (int v = 1; v <= f->num_literais; v++) {
+                usado += snprintf(linha + usado, sizeof(linha) - (size_t)usado, " %d", interpretacao[v] == 1 ? v : -v);
+                if (v % 20 == 0 || v == f->num_literais) {
+                    enviarLinha(t->conexao, "%ld v%s%s", t->id, linha, v == f->num_literais ? " 0" : "");
+                    usado = 0;
+                }
+            }
+            enviarLinha(t->conexao, "%ld fim SAT tempo=%.3f", t->id, tempo);
+        } else if (controle_atual->esgotado) {
+            enviarLinha(t->conexao, "%ld fim %s tempo=%.3f", t->id, nomeLimiteServidor(controle_atual->motivo), tempo);
+        } else if (resultado < 0) {
+            enviarLinha(t->conexao, "%ld fim ERRO memória insuficiente", t->id);
+        } else {
+            enviarLinha(t->conexao, "%ld fim UNSAT tempo=%.3f", t->id, tempo);
+        }
+    }
+    liberarRastreado(interpretacao);
+    liberar_arvore(raiz);
+    liberar_formula(f);
+}
+
+static void *trabalhadorServidor(void *arg)
+{
+    (void)arg;
+    Trabalho *t;
+    while ((t = desenfileirarTrabalho(&fila_servidor)) != NULL) {
+        if (t->conexao->perdida) {  // Ninguém vai ler a resposta
+            concluirTrabalho(t);
+            continue;
+        }
+        double inicio = segundosAgora();
+        ControleTrabalho controle;
+        configurarControle(&controle, t->prazo);
+        controle_atual = &controle;
+        enviarLinha(t->conexao, "%ld iniciado", t->id);
+        if (t->tipo == TRABALHO_GRAFO) executarTrabalhoGrafo(t, inicio);
+        else executarTrabalhoCNF(t, inicio);
+        controle_atual = NULL;
+        concluirTrabalho(t);
+    }
+    return NULL;
+}
+
+/**
+ * Interpreta uma linha de comando do cliente e, se for um trabalho, põe na fila
+ * @return false se o comando foi "encerrar"
+ */
+static bool tratarComando(Conexao *c, char *linha)
+{
+    char *salvo;
+    char *cmd = strtok_r(linha, " \t\r\n", &salvo);
+    if (!cmd) return true;
+    if (strcmp(cmd, "encerrar") == 0) {
+        enviarLinha(c, "0 encerrando");
+        return false;
+    }
+
+    TipoTrabalho tipo;
+    if (strcmp(cmd, "grafo") == 0) tipo = TRABALHO_GRAFO;
+    else if (strcmp(cmd, "cnf") == 0) tipo = TRABALHO_CNF;
+    else {
+        enviarLinha(c, "0 erro comando desconhecido: %s", cmd);
+        return true;
+    }
+
+    char *arquivo = strtok_r(NULL, " \t\r\n", &salvo);
+    if (!arquivo) {
+        enviarLinha(c, "0 erro falta o arquivo");
+        return true;
+    }
+    int k = 0, prioridade = 0;
+    double prazo = 0;
+    for (char *op = strtok_r(NULL, " \t\r\n", &salvo); op; op = strtok_r(NULL, " \t\r\n", &salvo)) {
+        if (strncmp(op, "k=", 2) == 0 && tipo == TRABALHO_GRAFO) k = atoi(op + 2);
+        else if (strncmp(op, "prazo=", 6) == 0) prazo = atof(op + 6);
+        else if (strncmp(op, "prioridade=", 11) == 0) prioridade = atoi(op + 11);
+        else {
+            enviarLinha(c, "0 erro opção desconhecida: %s", op);
+            return true;
+        }
+    }
+    if (k < 0 || prazo < 0) {
+        enviarLinha(c, "0 erro k e prazo não podem ser negativos");
+        return true;
+    }
+
+    Trabalho *t = malloc(sizeof(Trabalho));
+    char *copia = strdup(arquivo);
+    if (!t || !copia) {
+        free(t);
+        free(copia);
+        enviarLinha(c, "0 erro memória insuficiente");
+        return true;
+    }
+    t->id = __atomic_fetch_add(&proximo_id_trabalho, 1, __ATOMIC_RELAXED);
+    t->tipo = tipo;
+    t->arquivo = copia;
+    t->k = k;
+    t->prazo = prazo;
+    t->prioridade = prioridade;
+    t->conexao = c;
+
+    pthread_mutex_lock(&c->trava);
+    c->pendentes++;
+    pthread_mutex_unlock(&c->trava);
+    enviarLinha(c, "%ld aceito", t->id);
+    if (!enfileirarTrabalho(&fila_servidor, t)) {
+        enviarLinha(c, "%ld fim ERRO fila cheia", t->id);
+        concluirTrabalho(t);
+    }
+    return true;
+}
+
+// Thread de cada conexão: lê comandos até o cliente fechar a escrita, espera os trabalhos e fecha
+static void *atenderConexao(void *arg)
+{
+    Conexao *c = arg;
+    int fd_leitura = dup(c->fd);
+    FILE *entrada = fd_leitura >= 0 ? fdopen(fd_leitura, "r") : NULL;
+    char *linha = NULL;
+    size_t cap = 0;
+    bool continuar = true;
+
+    while (entrada && continuar && getline(&linha, &cap, entrada) >= 0) {
+        continuar = tratarComando(c, linha);
+    }
+    free(linha);
+    if (entrada) fclose(entrada);
+    else if (fd_leitura >= 0) close(fd_leitura);
+
+    if (!continuar) {  // "encerrar": para de aceitar conexões; a fila termina normalmente
+        pthread_mutex_lock(&fila_servidor.trava);
+        fila_servidor.encerrando = true;
+        pthread_cond_broadcast(&fila_servidor.tem_trabalho);
+        pthread_mutex_unlock(&fila_servidor.trava);
+        shutdown(socket_escuta, SHUT_RDWR);
+    }
+
+    pthread_mutex_lock(&c->trava);
+    while (c->pendentes > 0) pthread_cond_wait(&c->terminou, &c->trava);
+    pthread_mutex_unlock(&c->trava);
+
+    close(c->fd);
+    pthread_mutex_destroy(&c->trava);
+    pthread_cond_destroy(&c->terminou);
+    free(c);
+    return NULL;
+}
+
+/**
+ * Roda o modo servidor até receber "encerrar"
+ * @param caminho Caminho do socket Unix (recriado se já existir)
+ * @return Código de saída do programa
+ */
+int servidor(const char *caminho)
+{
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        printf("Erro: caminho do socket longo demais: %s\n", caminho);
+        return 1;
+    }
+    strcpy(endereco.sun_path, caminho);
+
+    socket_escuta = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socket_escuta < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(caminho);
+    if (bind(socket_escuta, (struct sockaddr*)&endereco, sizeof(endereco)) < 0 || listen(socket_escuta, 64) < 0) {
+        perror(caminho);
+        close(socket_escuta);
+        return 1;
+    }
+
+    mostrar_detalhes = false;  // Vários trabalhos ao mesmo tempo: sem mensagens das etapas
+    int num_trabalhadores = numeroThreads();
+    pthread_t *trabalhadores = malloc((size_t)num_trabalhadores * sizeof(pthread_t));
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, 64 << 20);  // SAT() é recursivo: pilha folgada
+    int criados = 0;
+    for (int i = 0; trabalhadores && i < num_trabalhadores; i++) {
+        if (pthread_create(&trabalhadores[i], &attr, trabalhadorServidor, NULL) == 0) criados++;
+    }
+    if (criados == 0) {
+        printf("Erro: não foi possível criar as threads de trabalho.\n");
+        free(trabalhadores);
+        close(socket_escuta);
+        unlink(caminho);
+        return 1;
+    }
+    printf("Servidor ouvindo em %s (%d thread%s de trabalho).\n", caminho, criados, criados > 1 ? "s" : "");
+    fflush(stdout);
+
+    pthread_attr_t attr_conexao;
+    pthread_attr_init(&attr_conexao);
+    pthread_attr_setdetachstate(&attr_conexao, PTHREAD_CREATE_DETACHED);
+    for (;;) {
+        int fd = accept(socket_escuta, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;  // Socket fechado por "encerrar"
+        }
+        Conexao *c = calloc(1, sizeof(Conexao));
+        pthread_t thread;
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        pthread_mutex_init(&c->trava, NULL);
+        pthread_cond_init(&c->terminou, NULL);
+        if (pthread_create(&thread, &attr_conexao, atenderConexao, c) != 0) {
+            pthread_mutex_destroy(&c->trava);
+            pthread_cond_destroy(&c->terminou);
+            close(fd);
+            free(c);
+        }
+    }
+
+    // Encerrando: as threads de trabalho esvaziam a fila e saem
+    for (int i = 0; i < criados; i++) pthread_join(trabalhadores[i], NULL);
+    pthread_attr_destroy(&attr);
+    pthread_attr_destroy(&attr_conexao);
+    free(trabalhadores);
+    free(fila_servidor.heap);
+    close(socket_escuta);
+    unlink(caminho);
+    printf("Servidor encerrado.\n");
+    return 0;
+}
+
+// 15ª ALTERAÇÃO: modo em lote (sem menu)
+//
+// "GCP_5 --lote [opções] <arquivos ou diretórios>" resolve vários grafos ao mesmo tempo,
+// um por thread, e escreve uma linha de resumo por instância (CSV ou JSONL), na ordem em
+// que terminam. Antes do SAT, uma clique gulosa (limite inferior) e a coloração gulosa
+// pela ordem do k-core (limite superior) resolvem sozinhas os casos em que se encontram.
+
+// Opções do modo em lote
+typedef struct {
+    int threads;            // Instâncias resolvidas ao mesmo tempo
+    int k;                  // K fixo (0 = achar o número cromático)
+    double prazo;           // Segundos por instância (0 = sem prazo)
+    bool jsonl;             // JSONL em vez de CSV
+} OpcoesLote;
 
+// Estado compartilhado pelas threads do lote
+typedef struct {
+    char **arquivos;
+    int num_arquivos;
+    int proximo;            // Próximo arquivo a pegar (atômico)
+    OpcoesLote opcoes;
+    FILE *saida;
+    pthread_mutex_t trava_saida;
+} TrabalhoLote;
+
+// Chaves (posição em ordem << 32 | vértice) em ordem decrescente: os vizinhos de maior núcleo primeiro
+static int compararChavesDecrescente(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x < y) - (x > y);
+}
+
+/**
+ * Clique gulosa: para cada vértice em ordem decrescente de núcleo, cresce uma clique com os
+ * vizinhos de maior núcleo. Serve de limite inferior para o número cromático.
+ * Cada semente só percorre os próprios vizinhos (ordenados pela posição em ordem), então custa
+ * O(grau · Δ) e não O(n).
+ * @param prazo Instante (segundosAgora) em que desiste e fica com a melhor até ali (0 = sem prazo)
+ * @return Tamanho da maior clique achada (0 se faltou memória)
+ */
+int cliqueGulosa(Grafo *g, const int *nucleo, const int *ordem, double prazo)
+{
     int n = g->n_vertices;
-    int m = g->m_arestas;
+    if (n == 0) return 0;
+    size_t grau_max = 0;
+    for (int v = 0; v < n; v++) {
+        size_t grau = g->adj_inicio[v + 1] - g->adj_inicio[v];
+        if (grau > grau_max) grau_max = grau;
+    }
+    int *posicao = malloc((size_t)n * sizeof(int));
+    int *marca = calloc((size_t)n, sizeof(int));
+    uint64_t *candidatos = malloc((grau_max > 0 ? grau_max : 1) * sizeof(uint64_t));
+    if (!posicao || !marca || !candidatos) {
+        free(posicao);
+        free(marca);
+        free(candidatos);
+        return 0;
+    }
+    for (int i = 0; i < n; i++) posicao[ordem[i]] = i;
 
-    int num_vars = n * k;
-    int num_clauses = 0;
+    int melhor = 1, selo = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        int v = ordem[i];
+        if (nucleo[v] + 1 <= melhor) break;  // Nenhuma clique com v passa de núcleo + 1
 
-    // Estimativa das cláusulas (n precisa ser exata, mas ajuda)
-    num_clauses += n;                       // Regra 1: pelo menos uma cor
-    num_clauses += n * (k * (k - 1)) / 2;   // Regra 2: no máximo uma cor
-    num_clauses += m * k;                  // Regra 3: adjacentes
+        // Candidatos: vizinhos de v; cada vértice aceito filtra os candidatos pelos vizinhos dele
+        int tam = 1;
+        size_t num_candidatos = 0;
+        selo++;
+        for (size_t j = g->adj_inicio[v]; j < g->adj_inicio[v + 1]; j++) {
+            int w = g->adj_vizinhos[j];
+            marca[w] = selo;
+            candidatos[num_candidatos++] = ((uint64_t)posicao[w] << 32) | (uint32_t)w;
+        }
+        qsort(candidatos, num_candidatos, sizeof(uint64_t), compararChavesDecrescente);
+        for (size_t c = 0; c < num_candidatos; c++) {
+            int w = (int)(uint32_t)candidatos[c];
+            if (marca[w] != selo) continue;
+            tam++;
+            selo++;
+            for (size_t j = g->adj_inicio[w]; j < g->adj_inicio[w + 1]; j++) {
+                if (marca[g->adj_vizinhos[j]] == selo - 1) marca[g->adj_vizinhos[j]] = selo;
+            }
+        }
+        if (tam > melhor) melhor = tam;
+        if ((prazo > 0 && segundosAgora() >= prazo) || limiteEsgotado()) break;  // Fica a melhor até aqui
+    }
+    free(posicao);
+    free(marca);
+    free(candidatos);
+    return melhor;
+}
 
-    fprintf(f, "p cnf %d %d\n", num_vars, num_clauses);
+// Escapa aspas e barras para o campo "arquivo" da saída
+static void escreverTexto(FILE *saida, const char *s, bool jsonl)
+{
+    fputc('"', saida);
+    for (; *s; s++) {
+        if (*s == '"') fputs(jsonl ? "\\\"" : "\"\"", saida);
+        else if (*s == '\\' && jsonl) fputs("\\\\", saida);
+        else fputc(*s, saida);
+    }
+    fputc('"', saida);
+}
 
-    // === Regra 1: cada vértice com pelo menos uma cor ===
-    for (int v = 1; v <= n; v++) {          // Para cada vértice do grafo
-        for (int c = 1; c <= k; c++) {      // Para cada cor possível
-            int var = (v - 1) * k + c;      // Calcula o índice da variável (v-1)*k + c → mapeia vértice + cor para literal
-            fprintf(f, "%d ", var);         // Escreve o literal correspondente (positivo) → quer dizer: "v tem cor c"
+// Resolve uma instância e escreve a linha de resumo
+static void resolverInstanciaLote(TrabalhoLote *t, const char *arquivo)
+{
+    double inicio = segundosAgora();
+    ControleTrabalho controle;
+    configurarControle(&controle, t->opcoes.prazo);
+    controle_atual = &controle;
+
+    Grafo g;
+    iniciarGrafo(&g);
+    const char *status = "erro";
+    const char *motor = "-";
+    int chi = 0, inferior = 0, superior = 0;
+    int *cores = NULL, *nucleo = NULL, *ordem = NULL, *marca = NULL;
+
+    if (!lerGrafo(arquivo, &g)) goto escrever;
+    int n = g.n_vertices;
+    if (g.num_lacos > 0) {
+        status = t->opcoes.k ? "unsat" : "sem_coloracao";
+        motor = "laco";
+        goto escrever;
+    }
+
+    cores = malloc(((size_t)n + 1) * sizeof(int));
+    nucleo = malloc(((size_t)n + 1) * sizeof(int));
+    ordem = malloc(((size_t)n + 1) * sizeof(int));
+    marca = calloc((size_t)n + 2, sizeof(int));
+    if (!cores || !nucleo || !ordem || !marca || !calcularNucleos(&g, nucleo, ordem)) goto escrever;
+
+    // Limites baratos: clique (23ª ALTERAÇÃO: máxima, com prazo) e coloração gulosa na ordem inversa do k-core
+    const char *env_clique = getenv("GCP_PRAZO_CLIQUE");
+    bool omega_exata;
+    inferior = cliqueMaxima(&g, env_clique ? atof(env_clique) : PRAZO_CLIQUE_PADRAO, &omega_exata);
+    for (int v = 0; v < n; v++) cores[v] = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        int v = ordem[i];
+        cores[v] = corGulosa(&g, v, n + 1, cores, marca, v + 1);
+        if (cores[v] > superior) superior = cores[v];
+    }
+    int k_denso = colorirDensoBits(&g, cores);  // 22ª ALTERAÇÃO: DSatur/RLF em bits, se o grafo é denso
+    if (k_denso > 0 && k_denso < superior) superior = k_denso;
+
+    int k = t->opcoes.k;
+    if (k ? (k >= superior || k < inferior) : inferior == superior) {
+        // Os limites já respondem: a gulosa cabe em K, ou há uma clique maior que K
+        motor = "limites";
+        if (!k) { status = "otimo"; chi = superior; }
+        else if (k >= superior) { status = "sat"; chi = superior; }
+        else status = "unsat";
+    } else {
+        motor = "sat";
+        int k_usado;
+        int r = colorirGrafoComLimite(&g, k, inferior, cores, &k_usado);  // A clique já foi procurada acima
+        if (r == 1) {
+            status = k ? "sat" : "otimo";
+            chi = k_usado;
+            if (!k) inferior = superior = k_usado;
+        } else if (r == 0) {
+            status = k ? "unsat" : "sem_coloracao";
+        } else if (controle.esgotado) {
+            // 18ª ALTERAÇÃO: os limites melhoram com o que a busca já provou e achou
+            status = nomeLimite(controle.motivo);
+            if (controle.limite_inferior > inferior) inferior = controle.limite_inferior;
+            if (k_usado > 0 && k_usado < superior) superior = k_usado;
+        } else {
+            status = "erro";
         }
-        fprintf(f, "0\n");                  // Termina a cláusula com 0 (requisito do formato DIMACS)
     }
 
+escrever:;
+    double tempo = segundosAgora() - inicio;
+    controle_atual = NULL;
+    pthread_mutex_lock(&t->trava_saida);
+    if (t->opcoes.jsonl) {
+        fputs("{\"arquivo\":", t->saida);
+        escreverTexto(t->saida, arquivo, true);
+        fprintf(t->saida, ",\"vertices\":%d,\"arestas\":%d,\"chi\":%d,\"status\":\"%s\",\"tempo\":%.6f,"
+                "\"motor\":\"%s\",\"limite_inferior\":%d,\"limite_superior\":%d}\n",
+                g.n_vertices, g.m_arestas, chi, status, tempo, motor, inferior, superior);
+    } else {
+        escreverTexto(t->saida, arquivo, false);
+        fprintf(t->saida, ",%d,%d,%d,%s,%.6f,%s,%d,%d\n",
+                g.n_vertices, g.m_arestas, chi, status, tempo, motor, inferior, superior);
+    }
+    fflush(t->saida);
+    pthread_mutex_unlock(&t->trava_saida);
 
-    // === Regra 2: vértice não pode ter 2 cores ao mesmo tempo ===
-    for (int v = 1; v <= n; v++) {                    // Para cada vértice
-        for (int c1 = 1; c1 <= k; c1++) {             // Para cada cor
-            for (int c2 = c1 + 1; c2 <= k; c2++) {    // Compara com todas as cores seguintes (evita repetição)
-                int var1 = (v - 1) * k + c1;          // Literal para vértice v com cor c1
-                int var2 = (v - 1) * k + c2;          // Literal para vértice v com cor c2
-                fprintf(f, "-%d -%d 0\n", var1, var2); // Escreve cláusula de exclusão: "-var1 ou -var2"
+    free(cores);
+    free(nucleo);
+    free(ordem);
+    free(marca);
+    liberarGrafo(&g);
+}
+
+static void *trabalhadorLote(void *arg)
+{
+    TrabalhoLote *t = arg;
+    for (;;) {
+        int i = __atomic_fetch_add(&t->proximo, 1, __ATOMIC_RELAXED);
+        if (i >= t->num_arquivos) break;
+        resolverInstanciaLote(t, t->arquivos[i]);
+    }
+    return NULL;
+}
+
+static int compararTextos(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Acrescenta um caminho à lista (que cresce dobrando)
+static bool incluirArquivo(char ***lista, int *n, int *cap, const char *caminho)
+{
+    if (*n == *cap) {
+        int nova = *cap ? 2 * *cap : 64;
+        char **novo = realloc(*lista, (size_t)nova * sizeof(char*));
+        if (!novo) return false;
+        *lista = novo;
+        *cap = nova;
+    }
+    char *copia = strdup(caminho);
+    if (!copia) return false;
+    (*lista)[(*n)++] = copia;
+    return true;
+}
+
+// Acrescenta os arquivos comuns de um diretório (sem ocultos), em ordem alfabética
+static bool incluirDiretorio(char ***lista, int *n, int *cap, const char *dir)
+{
+    DIR *d = opendir(dir);
+    if (!d) return false;
+    int antes = *n;
+    bool ok = true;
+    struct dirent *e;
+    while (ok && (e = readdir(d)) != NULL) {
+        if (e->d_name[0] == '.') continue;
+        size_t tam = strlen(dir) + strlen(e->d_name) + 2;
+        char *caminho = malloc(tam);
+        if (!caminho) { ok = false; break; }
+        snprintf(caminho, tam, "%s/%s", dir, e->d_name);
+        struct stat st;
+        if (stat(caminho, &st) == 0 && S_ISREG(st.st_mode)) ok = incluirArquivo(lista, n, cap, caminho);
+        free(caminho);
+    }
+    closedir(d);
+    qsort(*lista + antes, (size_t)(*n - antes), sizeof(char*), compararTextos);
+    return ok;
+}
+
+/**
+ * Abre a saída do resumo: o arquivo pedido ou o stdout original. No segundo caso o stdout
+ * das outras funções (mensagens de erro) passa a ir para stderr, para não sujar o resumo.
+ * @param nome Arquivo de saída ou NULL
+ * @return Arquivo aberto ou NULL (com a mensagem de erro já mostrada)
+ */
+FILE *abrirSaidaResumo(const char *nome)
+{
+    FILE *saida = NULL;
+    if (nome) {
+        saida = fopen(nome, "w");
+    } else {
+        int fd = dup(STDOUT_FILENO);
+        fflush(stdout);
+        if (fd >= 0 && dup2(STDERR_FILENO, STDOUT_FILENO) >= 0) saida = fdopen(fd, "w");
+    }
+    if (!saida) perror(nome ? nome : "stdout");
+    return saida;
+}
+
+/**
+ * Modo em lote: GCP_5 --lote [-j N] [-k K] [-t segundos] [--jsonl] [-o saida] <arquivos|diretórios>...
+ * Mensagens de erro e avisos vão para stderr; a saída tem só o resumo.
+ * @return Código de saída do programa
+ */
+int modoLote(int argc, char *argv[])
+{
+    OpcoesLote opcoes = { numeroThreads(), 0, 0, false };
+    const char *nome_saida = NULL;
+    char **arquivos = NULL;
+    int num_arquivos = 0, cap = 0;
+    bool ok = true;
+
+    for (int i = 0; ok && i < argc; i++) {
+        const char *a = argv[i];
+        bool tem_valor = i + 1 < argc;
+        if (strcmp(a, "-j") == 0 && tem_valor) opcoes.threads = atoi(argv[++i]);
+        else if (strcmp(a, "-k") == 0 && tem_valor) opcoes.k = atoi(argv[++i]);
+        else if (strcmp(a, "-t") == 0 && tem_valor) opcoes.prazo = atof(argv[++i]);
+        else if (strcmp(a, "-o") == 0 && tem_valor) nome_saida = argv[++i];
+        else if (strcmp(a, "--jsonl") == 0) opcoes.jsonl = true;
+        else if (strcmp(a, "--csv") == 0) opcoes.jsonl = false;
+        else if (a[0] == '-') {
+            fprintf(stderr, "Opção inválida: %s\n", a);
+            ok = false;
+        } else {
+            struct stat st;
+            if (stat(a, &st) == 0 && S_ISDIR(st.st_mode)) ok = incluirDiretorio(&arquivos, &num_arquivos, &cap, a);
+            else ok = incluirArquivo(&arquivos, &num_arquivos, &cap, a);
+            if (!ok) perror(a);
+        }
+    }
+    if (ok && num_arquivos == 0) {
+        fprintf(stderr, "Uso: GCP_5 --lote [-j N] [-k K] [-t segundos] [--jsonl] [-o saida] <arquivos|diretórios>...\n");
+        ok = false;
+    }
+    if (opcoes.threads < 1) opcoes.threads = 1;
+    if (opcoes.k < 0 || opcoes.prazo < 0) {
+        fprintf(stderr, "Erro: K e prazo não podem ser negativos.\n");
+        ok = false;
+    }
+
+    FILE *saida = NULL;
+    if (ok) {
+        saida = abrirSaidaResumo(nome_saida);
+        ok = saida != NULL;
+    }
+    if (ok && !opcoes.jsonl) {
+        fprintf(saida, "arquivo,vertices,arestas,chi,status,tempo,motor,limite_inferior,limite_superior\n");
+    }
+
+    if (ok) {
+        mostrar_detalhes = false;
+        TrabalhoLote t;
+        t.arquivos = arquivos;
+        t.num_arquivos = num_arquivos;
+        t.proximo = 0;
+        t.opcoes = opcoes;
+        t.saida = saida;
+        pthread_mutex_init(&t.trava_saida, NULL);
+
+        int num_threads = opcoes.threads < num_arquivos ? opcoes.threads : num_arquivos;
+        if (num_threads > 1) threads_por_instancia = 1;  // O paralelismo já está entre instâncias
+        pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstacksize(&attr, 64 << 20);  // SAT() é recursivo: pilha folgada
+        int criadas = 0;
+        for (int i = 0; threads && num_threads > 1 && i < num_threads; i++) {
+            if (pthread_create(&threads[i], &attr, trabalhadorLote, &t) == 0) criadas++;
+        }
+        if (criadas == 0) trabalhadorLote(&t);
+        for (int i = 0; i < criadas; i++) pthread_join(threads[i], NULL);
+        pthread_attr_destroy(&attr);
+        pthread_mutex_destroy(&t.trava_saida);
+        free(threads);
+    }
+
+    if (saida) fclose(saida);
+    for (int i = 0; i < num_arquivos; i++) free(arquivos[i]);
+    free(arquivos);
+    return ok ? 0 : 1;
+}
+
+// 16ª ALTERAÇÃO: bateria de desempenho com geradores de instâncias
+//
+// "GCP_5 --bench [-t segundos] [-o saida.csv] [-d diretório] [instâncias...]" gera cada
+// instância a partir da sua descrição (sempre o mesmo grafo para a mesma semente), roda cada
+// motor em um processo filho com prazo e escreve uma linha CSV por (instância, motor). O
+// processo filho isola o pico de memória (getrusage do filho) e garante o prazo mesmo se o
+// motor não parar sozinho. Descrições aceitas:
+//   gnp:n:p:semente         G(n, p) aleatório
+//   rainhas:n               grafo das rainhas n x n
+//   mycielski:m             grafo de Mycielski M_m (número cromático m, sem triângulos)
+//   geo:n:r:semente         grafo geométrico: n pontos no quadrado unitário, aresta se dist <= r
+//   plano:n:k:p:semente     k-colorível "plano": k classes de tamanho igual, arestas só entre
+//                           classes com probabilidade p (versão simples do gerador de Culberson)
+
+// Instâncias usadas quando nenhuma é passada: pequenas o bastante para o DPLL terminar
+static const char *const bateria_padrao[] = {
+    "gnp:20:0.3:1", "gnp:16:0.5:2", "gnp:30:0.2:3",
+    "rainhas:4", "rainhas:5",
+    "mycielski:3", "mycielski:4",
+    "geo:40:0.2:1", "geo:60:0.15:2",
+    "plano:24:3:0.4:1", "plano:30:4:0.5:2",
+};
+
+static const char *const motores_bench[] = { "completo", "sat", "csp", "guloso" };  // 24ª ALTERAÇÃO: csp
+
+// Gerador pseudoaleatório splitmix64: mesmo resultado em qualquer máquina
+static uint64_t proximoAleatorio(uint64_t *estado)
+{
+    uint64_t z = (*estado += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Número uniforme em [0, 1)
+static double aleatorioUnitario(uint64_t *estado)
+{
+    return (double)(proximoAleatorio(estado) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Gera a instância descrita por 'descricao' (ver formatos acima)
+ * @return false se a descrição é inválida ou faltou memória
+ */
+bool gerarInstancia(const char *descricao, Grafo *g)
+{
+    char familia[32];
+    double a = 0, b = 0, c = 0, d = 0;
+    iniciarGrafo(g);
+    int lidos = sscanf(descricao, "%31[^:]:%lf:%lf:%lf:%lf", familia, &a, &b, &c, &d);
+    if (lidos < 2 || a < 1 || a > 100000) return false;
+    int n = (int)a;
+    bool ok = true;
+
+    if (strcmp(familia, "gnp") == 0 && lidos == 4) {
+        uint64_t semente = (uint64_t)c;
+        g->n_vertices = n;
+        for (int u = 0; ok && u < n; u++) {
+            for (int v = u + 1; ok && v < n; v++) {
+                if (aleatorioUnitario(&semente) < b) ok = adicionarAresta(g, u, v);
+            }
+        }
+    } else if (strcmp(familia, "rainhas") == 0 && lidos == 2 && n <= 300) {
+        g->n_vertices = n * n;
+        for (int x = 0; ok && x < n * n; x++) {
+            for (int y = x + 1; ok && y < n * n; y++) {
+                int lx = x / n, cx = x % n, ly = y / n, cy = y % n;
+                if (lx == ly || cx == cy || lx - cx == ly - cy || lx + cx == ly + cy) ok = adicionarAresta(g, x, y);
+            }
+        }
+    } else if (strcmp(familia, "mycielski") == 0 && lidos == 2 && n <= 16) {
+        // M_1 = K_1, M_2 = K_2; M_{i+1}: cópia u_j de cada v_j ligada a N(v_j), mais w ligado a todo u_j
+        g->n_vertices = n >= 2 ? 2 : 1;
+        if (n >= 2) ok = adicionarAresta(g, 0, 1);
+        for (int i = 2; ok && i < n; i++) {
+            int atual = g->n_vertices;
+            int m_atual = g->m_arestas;
+            for (int e = 0; ok && e < m_atual; e++) {
+                int x = g->arestas[e][0], y = g->arestas[e][1];
+                ok = adicionarAresta(g, x, atual + y) && adicionarAresta(g, y, atual + x);
+            }
+            for (int j = 0; ok && j < atual; j++) ok = adicionarAresta(g, atual + j, 2 * atual);
+            g->n_vertices = 2 * atual + 1;
+        }
+    } else if (strcmp(familia, "geo") == 0 && lidos == 4) {
+        uint64_t semente = (uint64_t)c;
+        double *px = malloc((size_t)n * sizeof(double));
+        double *py = malloc((size_t)n * sizeof(double));
+        ok = px && py;
+        for (int v = 0; ok && v < n; v++) {
+            px[v] = aleatorioUnitario(&semente);
+            py[v] = aleatorioUnitario(&semente);
+        }
+        g->n_vertices = n;
+        for (int u = 0; ok && u < n; u++) {
+            for (int v = u + 1; ok && v < n; v++) {
+                double dx = px[u] - px[v], dy = py[u] - py[v];
+                if (dx * dx + dy * dy <= b * b) ok = adicionarAresta(g, u, v);
             }
         }
+        free(px);
+        free(py);
+    } else if (strcmp(familia, "plano") == 0 && lidos == 5 && b >= 1) {
+        // Classe de cada vértice embaralhada (Fisher-Yates) para não entregar a coloração pela numeração
+        uint64_t semente = (uint64_t)d;
+        int k = (int)b;
+        int *classe = malloc((size_t)n * sizeof(int));
+        ok = classe != NULL;
+        for (int v = 0; ok && v < n; v++) classe[v] = v % k;
+        for (int v = n - 1; ok && v > 0; v--) {
+            int j = (int)(proximoAleatorio(&semente) % (uint64_t)(v + 1));
+            int t = classe[v]; classe[v] = classe[j]; classe[j] = t;
+        }
+        g->n_vertices = n;
+        for (int u = 0; ok && u < n; u++) {
+            for (int v = u + 1; ok && v < n; v++) {
+                if (classe[u] != classe[v] && aleatorioUnitario(&semente) < c) ok = adicionarAresta(g, u, v);
+            }
+        }
+        free(classe);
+    } else {
+        return false;
     }
 
+    if (!ok || !construirAdjacencia(g)) {
+        liberarGrafo(g);
+        return false;
+    }
+    return true;
+}
+
+// Salva a instância no formato do projeto (n, m, '*', arestas numeradas a partir de 0)
+static bool salvarInstancia(Grafo *g, const char *dir, const char *descricao)
+{
+    char nome[4096];
+    int tam = snprintf(nome, sizeof(nome), "%s/", dir);
+    for (const char *p = descricao; *p && tam < (int)sizeof(nome) - 5; p++) nome[tam++] = *p == ':' ? '_' : *p;
+    strcpy(nome + tam, ".txt");
 
-    // === Regra 3: vértices adjacentes não podem ter mesma cor ===
-    for (int i = 0; i < m; i++) {                     // Para cada aresta do grafo
-        int u = g->arestas[i][0] + 1;                 // Vértice de origem (ajustando de 0 para 1)
-        int v = g->arestas[i][1] + 1;                 // Vértice de destino (ajustando de 0 para 1)
+    FILE *arquivo = fopen(nome, "w");
+    if (!arquivo) {
+        perror(nome);
+        return false;
+    }
+    fprintf(arquivo, "%d\n%d\n*\n", g->n_vertices, g->m_distintas);
+    for (int u = 0; u < g->n_vertices; u++) {
+        for (size_t j = g->adj_inicio[u]; j < g->adj_inicio[u + 1]; j++) {
+            if (g->adj_vizinhos[j] > u) fprintf(arquivo, "%d %d\n", u, g->adj_vizinhos[j]);
+        }
+    }
+    return fclose(arquivo) == 0;
+}
 
-        for (int c = 1; c <= k; c++) {                // Para cada cor
-            int var_u = (u - 1) * k + c;              // Literal que diz: "u tem cor c"
-            int var_v = (v - 1) * k + c;              // Literal que diz: "v tem cor c"
-            fprintf(f, "-%d -%d 0\n", var_u, var_v);  // Cláusula dizendo que os dois **não podem** ter a mesma cor
+/**
+ * Roda um motor no processo atual (já é o filho) e devolve o resultado no formato
+ * "status chi decisoes conflitos"
+ */
+static void rodarMotorBench(Grafo *g, const char *motor, double prazo, char *resultado, size_t tam)
+{
+    ControleTrabalho controle;
+    configurarControle(&controle, prazo);
+    controle_atual = &controle;
+    int n = g->n_vertices;
+    int *cores = malloc(((size_t)n + 1) * sizeof(int));
+    const char *status = "erro";
+    int chi = 0;
+
+    if (cores && strcmp(motor, "completo") == 0) {
+        int r = colorirGrafo(g, 0, cores, &chi);
+        status = r == 1 ? "otimo" : (r == 0 ? "sem_coloracao" : (controle.esgotado ? nomeLimite(controle.motivo) : "erro"));
+    } else if (cores && strcmp(motor, "sat") == 0) {
+        // SAT puro, sem reduções: K = 1, 2, ... até a primeira fórmula satisfatível
+        int r = n == 0 ? 1 : 0;
+        for (int k = 1; r == 0 && k <= n; k++) {
+            r = colorirSAT(g, k, cores);
+            if (r == 1) chi = k;
+        }
+        status = r == 1 ? "otimo" : (controle.esgotado ? nomeLimite(controle.motivo) : "erro");
+    } else if (cores && strcmp(motor, "csp") == 0) {
+        // 24ª ALTERAÇÃO: solver de domínios em bits, sem reduções: K = 1, 2, ... até MAX_CORES_CSP
+        int r = n == 0 ? 1 : 0;
+        for (int k = 1; r == 0 && k <= n && k <= MAX_CORES_CSP; k++) {
+            r = colorirCSP(g, k, cores);
+            if (r == 1) chi = k;
+        }
+        status = r == 1 ? "otimo" : (controle.esgotado ? nomeLimite(controle.motivo) : "erro");
+    } else if (cores && strcmp(motor, "guloso") == 0) {
+        // Coloração gulosa na ordem inversa do k-core (e DSatur/RLF em bits): sem prova de otimalidade
+        int *nucleo = malloc(((size_t)n + 1) * sizeof(int));
+        int *ordem = malloc(((size_t)n + 1) * sizeof(int));
+        int *marca = calloc((size_t)n + 2, sizeof(int));
+        if (nucleo && ordem && marca && calcularNucleos(g, nucleo, ordem)) {
+            for (int v = 0; v < n; v++) cores[v] = 0;
+            for (int i = n - 1; i >= 0; i--) {
+                int v = ordem[i];
+                cores[v] = corGulosa(g, v, n + 1, cores, marca, v + 1);
+                if (cores[v] > chi) chi = cores[v];
+            }
+            int k_denso = colorirDensoBits(g, cores);  // 22ª ALTERAÇÃO
+            if (k_denso > 0 && k_denso < chi) chi = k_denso;
+            status = "heuristico";
         }
+        free(nucleo);
+        free(ordem);
+        free(marca);
     }
 
+    controle_atual = NULL;
+    free(cores);
+    snprintf(resultado, tam, "%s %d %lld %lld", status, chi,
+             estatisticas_total.decisoes, estatisticas_total.conflitos);
+}
 
-    fclose(f);
+/**
+ * Roda um motor em um processo filho e escreve a linha CSV
+ * @return false se não foi possível criar o processo
+ */
+static bool medirMotor(FILE *saida, const char *descricao, Grafo *g, const char *motor, double prazo)
+{
+    int canal[2];
+    if (pipe(canal) < 0) {
+        perror("pipe");
+        return false;
+    }
+    fflush(NULL);
+    double inicio = segundosAgora();
+    pid_t filho = fork();
+    if (filho < 0) {
+        perror("fork");
+        close(canal[0]);
+        close(canal[1]);
+        return false;
+    }
+    if (filho == 0) {
+        close(canal[0]);
+        char resultado[256];
+        rodarMotorBench(g, motor, prazo, resultado, sizeof(resultado));
+        ssize_t r = write(canal[1], resultado, strlen(resultado));
+        _exit(r < 0 ? 1 : 0);
+    }
+    close(canal[1]);
+
+    // Espera o filho; se passar do prazo com folga, ele é morto
+    struct rusage uso;
+    memset(&uso, 0, sizeof(uso));
+    int estado = 0;
+    bool morto = false;
+    for (;;) {
+        pid_t r = wait4(filho, &estado, WNOHANG, &uso);
+        if (r == filho || (r < 0 && errno != EINTR)) break;
+        if (!morto && prazo > 0 && segundosAgora() - inicio > prazo + 1.0) {
+            kill(filho, SIGKILL);
+            morto = true;
+        }
+        struct timespec pausa = { 0, 2000000 };  // 2 ms
+        nanosleep(&pausa, NULL);
+    }
+    double tempo = segundosAgora() - inicio;
+
+    char resultado[256] = "";
+    ssize_t lidos = read(canal[0], resultado, sizeof(resultado) - 1);
+    close(canal[0]);
+    char status[64] = "erro";
+    int chi = 0;
+    long long decisoes = 0, conflitos = 0;
+    if (lidos > 0) {
+        resultado[lidos] = '\0';
+        sscanf(resultado, "%63s %d %lld %lld", status, &chi, &decisoes, &conflitos);
+    } else if (morto) {
+        strcpy(status, "tempo_esgotado");
+    }
+
+    fprintf(saida, "%s,%d,%d,%s,%s,%d,%.6f,%ld,%lld,%lld\n", descricao, g->n_vertices, g->m_distintas,
+            motor, status, chi, tempo, uso.ru_maxrss, decisoes, conflitos);
+    fflush(saida);
+    return true;
+}
+
+/**
+ * Modo bateria: GCP_5 --bench [-t segundos] [-o saida.csv] [-d diretório] [-m motor] [instâncias...]
+ * @return Código de saída do programa
+ */
+int modoBench(int argc, char *argv[])
+{
+    double prazo = 10;
+    const char *nome_saida = NULL, *dir = NULL, *so_motor = NULL;
+    // Cabem as instâncias da linha de comando ou, sem nenhuma, a bateria padrão
+    size_t num_padrao = sizeof(bateria_padrao) / sizeof(bateria_padrao[0]);
+    const char **instancias = malloc(((size_t)argc + 1 + num_padrao) * sizeof(char*));
+    int num_instancias = 0;
+    if (!instancias) return 1;
+
+    for (int i = 0; i < argc; i++) {
+        bool tem_valor = i + 1 < argc;
+        if (strcmp(argv[i], "-t") == 0 && tem_valor) prazo = atof(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0 && tem_valor) nome_saida = argv[++i];
+        else if (strcmp(argv[i], "-d") == 0 && tem_valor) dir = argv[++i];
+        else if (strcmp(argv[i], "-m") == 0 && tem_valor) so_motor = argv[++i];
+        else if (argv[i][0] == '-') {
+            fprintf(stderr, "Uso: GCP_5 --bench [-t segundos] [-o saida.csv] [-d diretório] [-m motor] [instâncias...]\n");
+            free(instancias);
+            return 1;
+        } else instancias[num_instancias++] = argv[i];
+    }
+    if (num_instancias == 0) {
+        for (size_t i = 0; i < num_padrao; i++) {
+            instancias[num_instancias++] = bateria_padrao[i];
+        }
+    }
+
+    FILE *saida = abrirSaidaResumo(nome_saida);
+    if (!saida) {
+        free(instancias);
+        return 1;
+    }
+    mostrar_detalhes = false;
+    threads_por_instancia = 1;  // Medidas comparáveis entre máquinas: uma thread por motor
+    fprintf(saida, "instancia,vertices,arestas,motor,status,chi,tempo,pico_rss_kb,decisoes,conflitos\n");
+
+    int falhas = 0;
+    for (int i = 0; i < num_instancias; i++) {
+        Grafo g;
+        if (!gerarInstancia(instancias[i], &g)) {
+            fprintf(stderr, "Instância inválida: %s\n", instancias[i]);
+            falhas++;
+            continue;
+        }
+        if (dir && !salvarInstancia(&g, dir, instancias[i])) falhas++;
+        for (size_t m = 0; m < sizeof(motores_bench) / sizeof(motores_bench[0]); m++) {
+            if (so_motor && strcmp(so_motor, motores_bench[m]) != 0) continue;
+            if (!medirMotor(saida, instancias[i], &g, motores_bench[m], prazo)) falhas++;
+        }
+        liberarGrafo(&g);
+    }
+
+    fclose(saida);
+    free(instancias);
+    return falhas ? 1 : 0;
+}
+
+// 17ª ALTERAÇÃO: estatísticas e progresso
+//
+// Ligados por variáveis de ambiente, como GCP_THREADS, GCP_CACHE_CNF e GCP_CNF_COMPACTA:
+//   GCP_PROGRESSO=s       uma linha de progresso em stderr a cada s segundos
+//   GCP_ESTATISTICAS=arq  JSON com tempos por etapa e contadores do SAT ao sair ("-" = stderr)
+// A etapa gerarCNF mede a montagem da fórmula em memória (obterFormula), que é o que o
+// programa usa desde a 6ª ALTERAÇÃO; o sat.cnf de depuração não entra na conta.
+
+static double inicio_programa;
+
+// Thread das linhas de progresso: dorme o intervalo e mostra o total até agora
+static void *threadProgresso(void *arg)
+{
+    double intervalo = *(double*)arg;
+    struct timespec pausa = { (time_t)intervalo, (long)((intervalo - (double)(time_t)intervalo) * 1e9) };
+    for (;;) {
+        nanosleep(&pausa, NULL);
+        int fase = __atomic_load_n(&fase_atual, __ATOMIC_RELAXED);
+        fprintf(stderr, "[progresso] %.1fs etapa=%s decisoes=%lld conflitos=%lld retrocessos=%lld\n",
+                segundosAgora() - inicio_programa, fase >= 0 ? nome_fase[fase] : "-",
+                __atomic_load_n(&estatisticas_total.decisoes, __ATOMIC_RELAXED),
+                __atomic_load_n(&estatisticas_total.conflitos, __ATOMIC_RELAXED),
+                __atomic_load_n(&estatisticas_total.retrocessos, __ATOMIC_RELAXED));
+    }
+    return NULL;
+}
+
+// Grava o JSON de estatísticas (registrado com atexit)
+static void escreverEstatisticasJSON(void)
+{
+    const char *nome = getenv("GCP_ESTATISTICAS");
+    FILE *saida = strcmp(nome, "-") == 0 ? stderr : fopen(nome, "w");
+    if (!saida) {
+        perror(nome);
+        return;
+    }
+    descarregarEstatisticas();  // O que ficou na thread principal
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+
+    fprintf(saida, "{\n  \"tempo_total\": %.6f,\n  \"pico_rss_kb\": %ld,\n  \"etapas\": {\n",
+            segundosAgora() - inicio_programa, uso.ru_maxrss);
+    for (int i = 0; i < NUM_FASES; i++) {
+        fprintf(saida, "    \"%s\": { \"segundos\": %.6f, \"chamadas\": %lld, \"pico_rss_kb\": %lld, "
+                "\"pico_rastreado_kb\": %lld }%s\n", nome_fase[i], (double)nanos_fase[i] * 1e-9, chamadas_fase[i],
+                pico_rss_fase[i], pico_rastreado_fase[i] / 1024, i + 1 < NUM_FASES ? "," : "");
+    }
+    EstatisticasSAT *e = &estatisticas_total;
+    fprintf(saida, "  },\n  \"sat\": { \"decisoes\": %lld, \"propagacoes\": %lld, \"conflitos\": %lld, "
+            "\"retrocessos\": %lld, \"reinicios\": %lld,\n",
+            e->decisoes, e->propagacoes, e->conflitos, e->retrocessos, e->reinicios);
+    // 25ª ALTERAÇÃO: cláusulas aprendidas pelo CDCL e o efeito da minimização
+    double aprendidas = e->aprendidas > 0 ? (double)e->aprendidas : 1.0;
+    fprintf(saida, "    \"aprendidas\": %lld, \"tamanho_medio_antes\": %.2f, \"tamanho_medio_depois\": %.2f, "
+            "\"razoes_fortalecidas\": %lld,\n", e->aprendidas, (double)e->literais_antes / aprendidas,
+            (double)e->literais_depois / aprendidas, e->fortalecidas);
+    // 26ª ALTERAÇÃO: rodadas de inprocessamento
+    fprintf(saida, "    \"inprocessamento\": { \"rodadas\": %lld, \"satisfeitas_removidas\": %lld, \"subsumidas\": %lld, "
+            "\"vivificadas\": %lld, \"literais_removidos\": %lld },\n", e->rodadas_inprocessamento,
+            e->satisfeitas_removidas, e->subsumidas, e->vivificadas, e->literais_removidos);
+    // 27ª ALTERAÇÃO: política de polaridade e refaseamentos
+    fprintf(saida, "    \"polaridade\": { \"politica\": \"%s\", \"refases\": {", nome_polaridade[politicaPolaridade()]);
+    for (int t = 0; t < NUM_REFASES; t++) {
+        fprintf(saida, " \"%s\": %lld%s", nome_refase[t], refases_total[t], t + 1 < NUM_REFASES ? "," : "");
+    }
+    fprintf(saida, " } } },\n");
+
+    // 19ª ALTERAÇÃO: memória rastreada por categoria
+    fprintf(saida, "  \"memoria\": { \"teto_kb\": %lld, \"teto_atingido\": %s, \"pico_rastreado_kb\": %lld,\n",
+            teto_memoria / 1024, teto_estourado ? "true" : "false", pico_rastreado / 1024);
+    for (int i = 0; i < NUM_CATEGORIAS_MEM; i++) {
+        fprintf(saida, "    \"%s\": { \"em_uso_kb\": %lld, \"pico_kb\": %lld }%s\n", nome_categoria_mem[i],
+                bytes_categoria[i] / 1024, pico_categoria[i] / 1024, i + 1 < NUM_CATEGORIAS_MEM ? "," : "");
+    }
+    fprintf(saida, "  }\n}\n");
+    if (saida != stderr) fclose(saida);
+}
+
+// Liga o progresso, o JSON de saída e o rastro conforme as variáveis de ambiente
+void iniciarInstrumentacao(void)
+{
+    static double intervalo;
+    inicio_programa = segundosAgora();
+    iniciarRastro();  // 20ª ALTERAÇÃO: GCP_RASTRO (só com -DRASTREAR_BUSCA=1)
+
+    const char *teto = getenv("GCP_MAX_MEMORIA_MB");  // 19ª ALTERAÇÃO: teto das estruturas do solver
+    if (teto) teto_memoria = atoll(teto) * 1024 * 1024;
+
+    const char *json = getenv("GCP_ESTATISTICAS");
+    if (json && *json) atexit(escreverEstatisticasJSON);
+
+    const char *progresso = getenv("GCP_PROGRESSO");
+    intervalo = progresso ? atof(progresso) : 0;
+    if (intervalo > 0) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, threadProgresso, &intervalo) == 0) pthread_detach(thread);
+    }
+}
+
+/**
+ * Imprime a coloração encontrada, um vértice por linha (numerados a partir de 1)
+ */
+void imprimirColoracao(Grafo *g, const int *cores)
+{
+    printf("Coloração encontrada:\n");
+    for (int v = 0; v < g->n_vertices; v++) {
+        printf("Vértice %d --> cor %d\n", v + 1, cores[v]);
+    }
+}
+
+
+// 18ª ALTERAÇÃO: limites de tempo, conflitos e memória no menu
+//
+// Os testes 1 e 2 rodam com os limites de GCP_PRAZO, GCP_MAX_CONFLITOS e GCP_MAX_MEMORIA_MB.
+// Ctrl-C (SIGINT) e SIGTERM viram um limite esgotado: a busca para e o que já foi feito é
+// mostrado. Um segundo sinal encerra na hora.
+
+static ControleTrabalho *controle_sinal = NULL;
+
+static void tratarSinalParada(int sinal)
+{
+    (void)sinal;
+    if (controle_sinal) esgotarControle(controle_sinal, LIMITE_SINAL);  // Só operações atômicas
+}
+
+void instalarSinaisParada(ControleTrabalho *c)
+{
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = tratarSinalParada;
+    acao.sa_flags = SA_RESETHAND;  // O segundo sinal tem o efeito normal
+    sigemptyset(&acao.sa_mask);
+    controle_sinal = c;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
 }
 
+/**
+ * Mostra o que a busca conseguiu antes de um limite acabar: melhor coloração, limite
+ * inferior provado e os valores de K que continuam em aberto
+ * @param k_fixo K pedido no teste único (0 no iterativo)
+ */
+void relatarLimite(Grafo *g, const int *cores, int k_usado, int k_fixo, ControleTrabalho *c)
+{
+    static const char *const descricao[] = { "", "tempo", "conflitos", "memória", "interrompido por sinal" };
+    int motivo = c->motivo >= LIMITE_TEMPO && c->motivo <= LIMITE_SINAL ? c->motivo : 0;
+    int inferior = c->limite_inferior;
+
+    printf("⏱ Limite atingido (%s): a busca parou antes de terminar.\n", descricao[motivo]);
+    if (k_fixo) {
+        printf("K = %d continua em aberto.\n", k_fixo);
+    } else if (k_usado <= 0) {  // Nenhuma coloração chegou a ser montada
+        printf("Limite inferior provado: %d.\n", inferior);
+    } else if (inferior >= k_usado) {
+        printf("Limite inferior provado: %d; a coloração abaixo já é ótima.\n", inferior);
+    } else if (inferior == k_usado - 1) {
+        printf("Limite inferior provado: %d; K em aberto: %d.\n", inferior, inferior);
+    } else {
+        printf("Limite inferior provado: %d; K em aberto: %d a %d.\n", inferior, inferior, k_usado - 1);
+    }
+    if (k_usado > 0) {
+        printf("Melhor coloração encontrada: %d cor%s.\n", k_usado, k_usado > 1 ? "es" : "");
+        imprimirColoracao(g, cores);
+    }
+}
 
-int main() { 
+int main(int argc, char *argv[]) { 
 
     setlocale(LC_ALL, "pt_BR.UTF-8");  // Define a localização/idioma para o sistema, garantindo acentuação correta no terminal
 
+    iniciarInstrumentacao();  // 17ª ALTERAÇÃO: GCP_PROGRESSO e GCP_ESTATISTICAS
+
+    // 14ª ALTERAÇÃO: "--servidor [socket]" troca o menu pelo modo servidor
+    if (argc > 1 && strcmp(argv[1], "--servidor") == 0) {
+        return servidor(argc > 2 ? argv[2] : CAMINHO_SOCKET_PADRAO);
+    }
+    if (argc > 1 && strcmp(argv[1], "--lote") == 0) {  // 15ª ALTERAÇÃO: modo em lote
+        return modoLote(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {  // 16ª ALTERAÇÃO: bateria de desempenho
+        return modoBench(argc - 2, argv + 2);
+    }
+
     Grafo g;        // Declara uma variável do tipo Grafo para armazenar os dados lidos do arquivo (vértices e arestas)
+    iniciarGrafo(&g);
+    const char *arquivo_grafo = argc > 1 ? argv[1] : "grafo.txt";  // 8ª ALTERAÇÃO: arquivo do grafo pode vir na linha de comando
     int k = 1;      // Inicializa a quantidade de cores K com 1. Esse valor será usado na versão iterativa.
     int option;     // Variável que vai armazenar a escolha do usuário no menu (1 ou 2)
+    ControleTrabalho controle;  // 18ª ALTERAÇÃO: limites dos testes 1 e 2
 
     // Exibe o menu de opções para o usuário escolher o tipo de teste que deseja realizar
-    printf("Boas vindas! Deseja qual tipo de teste?\n\n1 - Teste Único\n2 - Teste Iterativo\n\nDigite uma opção: ");
+    printf("Boas vindas! Deseja qual tipo de teste?\n\n1 - Teste Único\n2 - Teste Iterativo\n3 - Modo Incremental\n\nDigite uma opção: ");
     scanf("%d", &option);  // Lê do teclado a opção digitada pelo usuário e armazena na variável option
 
+    if (option == 1 || option == 2) {  // 18ª ALTERAÇÃO: limites do ambiente e Ctrl-C sem perder o trabalho
+        configurarControle(&controle, 0);
+        controle_atual = &controle;
+        instalarSinaisParada(&controle);
+    }
+
     // ==========================
     // OPÇÃO 1: TESTE ÚNICO
     // ==========================
@@ -440,7 +6964,7 @@ int main() {
         int k_manual;  // Variável para guardar o valor de K que será digitado manualmente pelo usuário
 
         // Tenta abrir e ler o grafo a partir do arquivo grafo.txt
-        if (!lerGrafo("grafo.txt", &g)) {
+        if (!lerGrafo(arquivo_grafo, &g)) {
             // Se a leitura falhar, mostra mensagem de erro e encerra o programa
             printf("Erro ao ler grafo!\n");
             return 1;
@@ -451,67 +6975,43 @@ int main() {
 
         // Pede ao usuário que digite a quantidade de cores desejada
         printf("Digite a quantidade de cores (K): ");
-        scanf("%d", &k_manual); // Lê o valor de K digitado
-
-        // Gera o arquivo CNF com base no grafo e no valor K digitado
-        gerarCNF(&g, k_manual, "sat.cnf");
-
-        // Lê a fórmula CNF do arquivo que foi gerado
-        Formula *f = ler_formula("sat.cnf");
-        if (!f) { // Se ocorrer erro ao ler a fórmula
-            printf("Erro ao processar CNF.\n");
+        if (scanf("%d", &k_manual) != 1 || k_manual < 1) {  // K = 0 é o "achar o menor K" de colorirGrafo
+            printf("K inválido: digite um inteiro maior ou igual a 1.\n");
+            liberarGrafo(&g);
             return 1;
         }
 
-        // Aloca um vetor para armazenar a interpretação (valores atribuídos às variáveis)
-        int *interpretacao = calloc( f->num_literais + 1 , sizeof(int) );  // +1 pois não usamos o índice 0
-        if (!interpretacao) { // Se falhar a alocação
-            liberar_formula(f); // Libera a memória da fórmula antes de sair
-            printf("Erro ao alocar vetor de interpretação.\n");
-            return 1;
-        }
+        // Exporta o sat.cnf apenas quando a depuração estiver ligada
+        if (EXPORTAR_CNF) gerarCNF(&g, k_manual, "sat.cnf");
 
-        // Aloca a raiz da árvore binária usada na busca pelo SAT
-        BinaryTree *raiz = malloc(sizeof(BinaryTree));
-        if (!raiz) { // Se falhar a alocação da raiz
-            free(interpretacao);         // Libera a memória da interpretação
-            liberar_formula(f);          // Libera a fórmula CNF
-            printf("Erro ao alocar árvore.\n");
+        // Resolve o K pedido (dominação, componentes conexas, k-core e SAT no que sobrar)
+        int *cores = malloc((g.n_vertices > 0 ? g.n_vertices : 1) * sizeof(int));
+        int k_usado = 0;
+        int resultado = cores ? colorirGrafo(&g, k_manual, cores, &k_usado) : -1;
+        if (resultado < 0 && controle.esgotado) {  // Um limite acabou antes da resposta
+            relatarLimite(&g, cores, k_usado, k_manual, &controle);
+            free(cores);
+            liberarGrafo(&g);
+            return 2;
+        }
+        if (resultado < 0) { // Se ocorrer erro ao montar ou resolver a fórmula
+            printf("Erro ao processar CNF.\n");
+            free(cores);
+            liberarGrafo(&g);
             return 1;
         }
 
-        // Inicializa os campos da raiz
-        raiz->variavel = 0;               // Variável 0 (ainda não atribuída)
-        raiz->valor = 0;                  // Valor neutro, nem negativo e nem positivo
-        raiz->esquerda = raiz->direita = NULL; // Ponteiros nulos (sem filhos ainda)
-
-        // Executa o SAT Solver com a fórmula e a raiz da árvore
-        if (SAT(f, interpretacao, raiz)) {
+        if (resultado == 1) {
             // Se for satisfatível, imprime o resultado
             printf("✔ SAT: fórmula satisfatível!\n");
             printf("Coloração possível com %d cor%s!\n", k_manual, k_manual > 1 ? "es" : "");
-            printf("Coloração encontrada:\n");
-
-            // Varre todos os vértices e imprime a cor atribuída a cada um
-            for (int v = 1; v <= g.n_vertices; v++) {
-                for (int cor = 1; cor <= k_manual; cor++) {
-                    int var_index = (v - 1) * k_manual + cor; // Cálculo da posição do literal na interpretação
-                    if (interpretacao[var_index] == 1) { // Se a variável está como verdadeira
-                        printf("Vértice %d --> cor %d\n", v, cor); // Imprime a cor daquele vértice
-                        break; // Sai do loop das cores (já encontrou a cor do vértice)
-                    }
-                }
-            }
-
+            imprimirColoracao(&g, cores); // Imprime a cor atribuída a cada vértice
         } else {
             // Se não for satisfatível, imprime que não é possível
             printf("✘ UNSAT: não é possível colorir com %d cor%s.\n", k_manual, k_manual > 1 ? "es" : "");
         }
 
-        // Libera a memória alocada
-        liberar_formula(f);
-        free(interpretacao);
-        liberar_arvore(raiz);
+        free(cores);
     }
 
     // ==========================
@@ -520,7 +7020,7 @@ int main() {
     else if( option == 2 )  // Se o usuário escolheu Teste Iterativo
     {
         // Tenta ler o grafo a partir do arquivo
-        if (!lerGrafo("grafo.txt", &g)) {
+        if (!lerGrafo(arquivo_grafo, &g)) {
             printf("Erro ao ler grafo!\n");
             return 1;
         }
@@ -528,87 +7028,64 @@ int main() {
         // Mostra as informações do grafo lido
         printf("Grafo com %d vertices e %d arestas.\n", g.n_vertices, g.m_arestas); 
 
-        // Loop para tentar coloração com 1 até N ( quantidade de vértices) cores
-        while (k <= g.n_vertices) {
-            // Informa o valor atual de K que será testado
-            printf("Testando coloração com %d cor%s...\n", k, k > 1 ? "es" : "");
-
-            // Gera o arquivo CNF com o valor atual de K
-            gerarCNF(&g, k, "sat.cnf");
-
-            // Lê a fórmula CNF gerada
-            Formula *f = ler_formula("sat.cnf");
-            if (!f) {
-                printf("Erro ao processar CNF.\n");
-                return 1;
-            }
-
-            // Aloca o vetor de interpretação
-            int *interpretacao = calloc( f->num_literais + 1 , sizeof(int) );
-            if (!interpretacao) {   // Se houver algum problema, finaliza
-                liberar_formula(f);
-                printf("Erro ao alocar vetor de interpretação.\n");
-                return 1;
-            }
-
-            // Aloca e inicializa a raiz da árvore de decisão
-            BinaryTree *raiz = malloc(sizeof(BinaryTree));
-            if (!raiz) {    // Se houver algum problema, finaliza
-                free(interpretacao);
-                liberar_formula(f);
-                printf("Erro ao alocar árvore.\n");
-                return 1;
-            }
-            raiz->variavel = 0;
-            raiz->valor = 0;
-            raiz->esquerda = raiz->direita = NULL;
-
-            // Executa o SAT Solver
-            if (SAT(f, interpretacao, raiz)) {
-                // Se for satisfatível, imprime a coloração encontrada
-                printf("✔ SAT: fórmula satisfatível!\n");
-                printf("Coloração possível com %d cor%s!\n", k, k > 1 ? "es" : "");
-                printf("Coloração encontrada:\n");
-
-                // Para cada vértice, imprime sua cor
-                for (int v = 1; v <= g.n_vertices; v++) {
-                    for (int cor = 1; cor <= k; cor++) {
-                        int var_index = (v - 1) * k + cor;
-                        if (interpretacao[var_index] == 1) {
-                            printf("Vértice %d --> cor %d\n", v, cor);
-                            break;
-                        }
-                    }
-                }
-
-                // Libera memória e encerra o programa (já encontrou solução)
-                liberar_formula(f);
-                free(interpretacao);
-                liberar_arvore(raiz);
-                return 0;
-            }
+        // Com um laço, nenhum K resolve: não adianta testar todos
+        if (g.num_lacos > 0) {
+            printf("Nenhuma coloracao possivel: o vertice %d tem laco.\n", g.lacos[0] + 1);
+            liberarGrafo(&g);
+            return 0;
+        }
 
-            // Se não for satisfatível, tenta com mais uma cor
-            liberar_formula(f);
-            free(interpretacao);
-            liberar_arvore(raiz);
-            printf("✘ Nao eh possivel com %d cor%s.\n\n", k, k > 1 ? "es" : "");
-            
-            k++; // Incrementa o número de cores e continua o loop
+        // Acha o menor K: cada componente conexa testa K crescente a partir do maior K já
+        // exigido por outra (o número cromático do grafo é o maior entre as componentes)
+        int *cores = malloc((g.n_vertices > 0 ? g.n_vertices : 1) * sizeof(int));
+        int resultado = cores ? colorirGrafo(&g, 0, cores, &k) : -1;
+        if (resultado < 0 && controle.esgotado) {  // Um limite acabou: mostra o melhor até aqui
+            relatarLimite(&g, cores, cores ? k : 0, 0, &controle);  // Sem vetor, não há coloração a mostrar
+            free(cores);
+            liberarGrafo(&g);
+            return 2;
+        }
+        if (resultado < 0) {
+            printf("Erro ao processar CNF.\n");
+            free(cores);
+            liberarGrafo(&g);
+            return 1;
         }
 
-        // Se o loop terminar sem encontrar coloração, imprime mensagem final
-        printf("Nenhuma coloracao possivel com K ≤ %d. Verifique o grafo.\n", g.n_vertices);
+        // Imprime a coloração encontrada
+        printf("✔ SAT: fórmula satisfatível!\n");
+        printf("Coloração possível com %d cor%s!\n", k, k > 1 ? "es" : "");
+        imprimirColoracao(&g, cores);
+        free(cores);
+    }
+
+    // ==========================
+    // OPÇÃO 3: MODO INCREMENTAL (13ª ALTERAÇÃO)
+    // ==========================
+    else if( option == 3 )  // Grafo e coloração ficam na memória; arestas chegam por comandos
+    {
+        if (!lerGrafo(arquivo_grafo, &g)) {
+            printf("Erro ao ler grafo!\n");
+            return 1;
+        }
+        printf("Grafo com %d vertices e %d arestas.\n", g.n_vertices, g.m_arestas);
+        if (g.num_lacos > 0) {
+            printf("Nenhuma coloracao possivel: o vertice %d tem laco.\n", g.lacos[0] + 1);
+            liberarGrafo(&g);
+            return 0;
+        }
+        modoIncremental(&g);
     }
 
     // ==========================
     // OPÇÃO INVÁLIDA
     // ==========================
     else {
-        // Caso o usuário digite uma opção diferente de 1 ou 2
+        // Caso o usuário digite uma opção diferente de 1, 2 ou 3
         printf("Opção inexistente!\nFechando o programa.\n");
     }
 
+    liberarGrafo(&g);
     return 0; // Retorna 0, indicando que o programa terminou com sucesso
 }
 
@@ -619,5 +7096,28 @@ int main() {
  * 3ª ALTERAÇÃO: função lerGrafo
  * 4ª ALTERAÇÃO: função gerarCNF
  * 5ª ALTERAÇÃO: criação de menu
+ * 6ª ALTERAÇÃO: fórmula montada direto na memória (construirFormula), sat.cnf só para depuração
+ * 7ª ALTERAÇÃO: formato binário .bcnf (gerarCNF/carregarFormulaBinaria) e cache por grafo/K em GCP_CACHE_CNF
+ * 8ª ALTERAÇÃO: arestas no heap (sem MAX_ARESTAS fixo), lerGrafo aceita DIMACS .col e lista de arestas
+ * 9ª ALTERAÇÃO: adjacência CSR ordenada e sem repetições (construirAdjacencia), usada na Regra 3
+ * 10ª ALTERAÇÃO: colorirSAT/colorirComK separados da main, redução k-core (calcularNucleos) antes do CNF
+ * 11ª ALTERAÇÃO: componentes conexas (union-find) resolvidas em paralelo por resolverComponentes
+ * 12ª ALTERAÇÃO: redução por vértices dominados e gêmeos falsos (reduzirDominados/colorirGrafo)
+ * 13ª ALTERAÇÃO: modo incremental (opção 3) com reparo local da coloração (modoIncremental)
+ * 14ª ALTERAÇÃO: modo servidor por socket Unix com fila de prioridade e prazo por trabalho (servidor, GCP_Cliente.c)
+ * 15ª ALTERAÇÃO: modo em lote com resumo CSV/JSONL por instância e limites gulosos (modoLote)
+ * 16ª ALTERAÇÃO: bateria de desempenho com geradores determinísticos e contadores do SAT (modoBench)
+ * 17ª ALTERAÇÃO: contadores da busca, tempo por etapa, progresso periódico e JSON de estatísticas
+ * 18ª ALTERAÇÃO: limites de tempo/conflitos/memória com a melhor coloração e os K em aberto
+ * 19ª ALTERAÇÃO: memória rastreada por categoria, teto de memória e pico por etapa (alocarRastreado)
+ * 20ª ALTERAÇÃO: rastro binário opcional da busca com anéis por thread (-DRASTREAR_BUSCA=1, GCP_Rastro.c)
+ * 21ª ALTERAÇÃO: avaliação de até 256 interpretações por passada (avaliarFormulaLote, AVX2) e busca local em lote (GCP_BUSCA_LOCAL)
+ * 22ª ALTERAÇÃO: matriz de adjacência em bits com núcleos AVX2/portáteis, DSatur e RLF para grafos densos (colorirDensoBits)
+ * 23ª ALTERAÇÃO: clique máxima exata com bits (BBMC) em paralelo e com prazo, ponto de partida do laço de K (cliqueMaxima)
+ * 24ª ALTERAÇÃO: solver de domínios em bits para K <= 64 (verificação adiante + DSatur, sem CNF), instanciado por macro (colorirCSP)
+ * 25ª ALTERAÇÃO: solver CDCL (satCDCL) com minimização recursiva e fortalecimento das razões na análise; GCP_SAT=dpll volta ao SAT()
+ * 26ª ALTERAÇÃO: inprocessamento no CDCL (limpeza do nível 0, subsunção entre aprendidas, vivificação) com esforço proporcional às propagações
+ * 27ª ALTERAÇÃO: polaridade das decisões do CDCL (GCP_POLARIDADE: original, invertida, salva, alvo) e refaseamento em ciclo, inclusive por busca local
+ * 28ª ALTERAÇÃO: decisões pelo grafo (DSatur: vértice com menos cores possíveis, cor menos usada) no CDCL e no SAT(), com o mapa variável → (vértice, cor) exportado pelo construtor da fórmula (GCP_RAMIFICACAO=generica desliga)
  * 
  */
@@ -0,0 +1,121 @@
+#include <stdio.h>      // printf, getline
+#include <stdlib.h>     // realpath, free
+#include <stdbool.h>    // bool
+#include <string.h>     // strcmp, strncmp
+#include <limits.h>     // PATH_MAX
+#include <errno.h>      // errno
+#include <unistd.h>     // read, write, close
+#include <sys/socket.h> // Socket Unix
+#include <sys/un.h>     // sockaddr_un
+
+// Cliente de teste do modo servidor do GCP_5 ("GCP_5 --servidor [socket]").
+//
+// Uso: GCP_Cliente [-s socket] [comando ...]
+// Cada argumento é uma linha de comando ("grafo g.txt k=3 prazo=10"); sem argumentos, os
+// comandos vêm da entrada padrão, um por linha. O cliente envia tudo, fecha a escrita e
+// mostra as respostas conforme chegam, até o servidor fechar a conexão.
+
+#define CAMINHO_SOCKET_PADRAO "/tmp/gcp5.sock"  // O mesmo do GCP_5
+
+// Escreve todos os bytes (write pode escrever só uma parte)
+static bool escreverTudo(int fd, const char *dados, size_t n)
+{
+    while (n > 0) {
+        ssize_t r = write(fd, dados, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        dados += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+/**
+ * Envia uma linha de comando. O arquivo de "grafo"/"cnf" vira caminho absoluto,
+ * pois o servidor pode estar rodando em outro diretório.
+ */
+static bool enviarComando(int fd, const char *comando)
+{
+    char copia[4096];
+    snprintf(copia, sizeof(copia), "%s", comando);
+    copia[strcspn(copia, "\r\n")] = '\0';
+
+    char *resto = copia;
+    while (*resto == ' ' || *resto == '\t') resto++;
+    if (strncmp(resto, "grafo ", 6) == 0 || strncmp(resto, "cnf ", 4) == 0) {
+        char *arquivo = strchr(resto, ' ');
+        while (*arquivo == ' ') arquivo++;
+        size_t tam = strcspn(arquivo, " \t");
+        char salvo = arquivo[tam];
+        arquivo[tam] = '\0';
+
+        char absoluto[PATH_MAX];
+        if (realpath(arquivo, absoluto)) {
+            size_t tam_cmd = (size_t)(arquivo - resto);
+            arquivo[tam] = salvo;
+            return escreverTudo(fd, resto, tam_cmd) &&
+                   escreverTudo(fd, absoluto, strlen(absoluto)) &&
+                   escreverTudo(fd, arquivo + tam, strlen(arquivo + tam)) &&
+                   escreverTudo(fd, "\n", 1);
+        }
+        arquivo[tam] = salvo;  // Não existe aqui: o servidor responde com o erro
+    }
+    return escreverTudo(fd, resto, strlen(resto)) && escreverTudo(fd, "\n", 1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *caminho = CAMINHO_SOCKET_PADRAO;
+    int primeiro = 1;
+    if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+        caminho = argv[2];
+        primeiro = 3;
+    }
+
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        printf("Erro: caminho do socket longo demais: %s\n", caminho);
+        return 1;
+    }
+    strcpy(endereco.sun_path, caminho);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) < 0) {
+        perror(caminho);
+        return 1;
+    }
+
+    // Envia os comandos (argumentos ou entrada padrão) e avisa que não há mais nenhum
+    bool ok = true;
+    if (primeiro < argc) {
+        for (int i = primeiro; ok && i < argc; i++) ok = enviarComando(fd, argv[i]);
+    } else {
+        char *linha = NULL;
+        size_t cap = 0;
+        while (ok && getline(&linha, &cap, stdin) >= 0) ok = enviarComando(fd, linha);
+        free(linha);
+    }
+    if (!ok) {
+        perror("envio");
+        close(fd);
+        return 1;
+    }
+    shutdown(fd, SHUT_WR);
+
+    // Mostra as respostas na ordem em que chegam
+    char buf[65536];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("leitura");
+            break;
+        }
+        fwrite(buf, 1, (size_t)n, stdout);
+        fflush(stdout);
+    }
+    close(fd);
+    return 0;
+}
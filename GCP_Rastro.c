@@ -0,0 +1,198 @@
+#include <stdio.h>      // printf, fopen
+#include <stdlib.h>     // malloc, qsort
+#include <stdbool.h>    // bool
+#include <string.h>     // strcmp, memcmp
+#include <stdint.h>     // Inteiros de tamanho fixo (registros do rastro)
+
+// Conversor do rastro binário da busca do GCP_5 (GCP_5 compilado com -DRASTREAR_BUSCA=1 e
+// rodado com GCP_RASTRO=arquivo).
+//
+// Uso: GCP_Rastro <arquivo> [--linha-do-tempo [ms] | --resumo]
+//   --linha-do-tempo  CSV com os eventos de cada thread em janelas de 'ms' milissegundos (padrão 100)
+//   --resumo          pilhas "dobradas" (thread;SAT;profundidade...) com o tempo em microssegundos
+//                     passado em cada faixa de profundidade, prontas para o flamegraph.pl
+
+// Mesma definição do GCP_5 (20ª ALTERAÇÃO)
+typedef struct {
+    uint64_t tempo_ns;
+    int32_t valor;
+    uint16_t profundidade;
+    uint8_t tipo;
+    uint8_t thread;
+} RegistroRastro;
+
+enum {
+    RASTRO_INICIO_SAT = 1, RASTRO_FIM_SAT, RASTRO_DECISAO, RASTRO_CONFLITO,
+    RASTRO_RETROCESSO, RASTRO_REINICIO, RASTRO_PERDIDOS
+};
+
+#define FAIXA_PROFUNDIDADE 10  // Largura de cada nível do resumo
+
+// Ordem do tempo; empate fica por thread (qsort não é estável)
+static int compararRegistros(const void *a, const void *b)
+{
+    const RegistroRastro *x = a, *y = b;
+    if (x->tempo_ns != y->tempo_ns) return x->tempo_ns < y->tempo_ns ? -1 : 1;
+    return (int)x->thread - (int)y->thread;
+}
+
+/**
+ * Lê o arquivo inteiro e ordena os registros pelo tempo (cada thread grava o seu anel
+ * separadamente, então o arquivo não vem em ordem)
+ * @return Vetor de registros (liberar com free) ou NULL em caso de erro
+ */
+static RegistroRastro *lerRastro(const char *nome, size_t *num)
+{
+    FILE *f = fopen(nome, "rb");
+    if (!f) {
+        perror(nome);
+        return NULL;
+    }
+    char assinatura[8];
+    uint32_t cabecalho[2];
+    if (fread(assinatura, 1, 8, f) != 8 || memcmp(assinatura, "GCPRASTR", 8) != 0 ||
+        fread(cabecalho, sizeof(cabecalho), 1, f) != 1 || cabecalho[0] != 1 ||
+        cabecalho[1] != sizeof(RegistroRastro)) {
+        printf("Erro: %s não é um rastro do GCP_5 (versão 1).\n", nome);
+        fclose(f);
+        return NULL;
+    }
+
+    size_t cap = 1 << 16, n = 0;
+    RegistroRastro *registros = malloc(cap * sizeof(RegistroRastro));
+    while (registros) {
+        if (n == cap) {
+            RegistroRastro *novo = realloc(registros, 2 * cap * sizeof(RegistroRastro));
+            if (!novo) {
+                free(registros);
+                registros = NULL;
+                break;
+            }
+            registros = novo;
+            cap *= 2;
+        }
+        size_t lidos = fread(registros + n, sizeof(RegistroRastro), cap - n, f);
+        n += lidos;
+        if (lidos == 0) break;
+    }
+    fclose(f);
+    if (!registros) {
+        printf("Erro: memória insuficiente para o rastro.\n");
+        return NULL;
+    }
+    qsort(registros, n, sizeof(RegistroRastro), compararRegistros);
+    *num = n;
+    return registros;
+}
+
+// Contagem de uma janela da linha do tempo para uma thread
+typedef struct {
+    long long decisoes, conflitos, retrocessos, reinicios, perdidos;
+    long long soma_profundidade, eventos;
+    int profundidade_max;
+} Janela;
+
+static void escreverJanela(uint64_t inicio_ms, int thread, Janela *j)
+{
+    if (j->eventos == 0) return;
+    printf("%llu,%d,%lld,%lld,%lld,%lld,%.1f,%d,%lld\n", (unsigned long long)inicio_ms, thread,
+           j->decisoes, j->conflitos, j->retrocessos, j->reinicios,
+           (double)j->soma_profundidade / (double)j->eventos, j->profundidade_max, j->perdidos);
+    memset(j, 0, sizeof(*j));
+}
+
+static void linhaDoTempo(const RegistroRastro *r, size_t n, uint64_t janela_ms)
+{
+    Janela janelas[256];
+    memset(janelas, 0, sizeof(janelas));
+    uint64_t janela_ns = janela_ms * 1000000u, atual = 0;
+
+    printf("inicio_ms,thread,decisoes,conflitos,retrocessos,reinicios,profundidade_media,profundidade_max,perdidos\n");
+    for (size_t i = 0; i <= n; i++) {
+        uint64_t bloco = i < n ? r[i].tempo_ns / janela_ns : UINT64_MAX;
+        if (bloco != atual) {
+            for (int t = 0; t < 256; t++) escreverJanela(atual * janela_ms, t, &janelas[t]);
+            atual = bloco;
+        }
+        if (i == n) break;
+
+        Janela *j = &janelas[r[i].thread];
+        j->eventos++;
+        j->soma_profundidade += r[i].profundidade;
+        if (r[i].profundidade > j->profundidade_max) j->profundidade_max = r[i].profundidade;
+        switch (r[i].tipo) {
+            case RASTRO_DECISAO:    j->decisoes++; break;
+            case RASTRO_CONFLITO:   j->conflitos++; break;
+            case RASTRO_RETROCESSO: j->retrocessos++; break;
+            case RASTRO_REINICIO:   j->reinicios++; break;
+            case RASTRO_PERDIDOS:   j->perdidos += r[i].valor; break;
+            default: break;
+        }
+    }
+}
+
+/**
+ * Resumo para flame graph: o tempo entre dois eventos da mesma thread, dentro de um SAT,
+ * vai para a profundidade em que a thread estava. Cada faixa de 10 níveis é um quadro da
+ * pilha, então a largura de cada quadro mostra quanto tempo a busca passou daquela
+ * profundidade para baixo.
+ */
+static void resumo(const RegistroRastro *r, size_t n)
+{
+    enum { MAX_FAIXAS = 65536 / FAIXA_PROFUNDIDADE + 1 };
+    static long long micros[256][MAX_FAIXAS];
+    uint64_t anterior[256];
+    int profundidade[256];
+    bool dentro[256];
+    memset(dentro, 0, sizeof(dentro));
+    int maior_faixa = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        int t = r[i].thread;
+        if (dentro[t]) {
+            int faixa = profundidade[t] / FAIXA_PROFUNDIDADE;
+            micros[t][faixa] += (long long)((r[i].tempo_ns - anterior[t]) / 1000u);
+            if (faixa > maior_faixa) maior_faixa = faixa;
+        }
+        if (r[i].tipo == RASTRO_INICIO_SAT) dentro[t] = true;
+        else if (r[i].tipo == RASTRO_FIM_SAT) dentro[t] = false;
+        else if (r[i].tipo != RASTRO_PERDIDOS) dentro[t] = true;  // Busca sem INICIO (regiões, servidor)
+        anterior[t] = r[i].tempo_ns;
+        profundidade[t] = r[i].profundidade;
+    }
+
+    for (int t = 0; t < 256; t++) {
+        for (int faixa = 0; faixa <= maior_faixa; faixa++) {
+            if (micros[t][faixa] == 0) continue;
+            printf("thread %d;SAT", t);
+            for (int nivel = 0; nivel <= faixa; nivel++) {
+                printf(";prof %d-%d", nivel * FAIXA_PROFUNDIDADE, nivel * FAIXA_PROFUNDIDADE + FAIXA_PROFUNDIDADE - 1);
+            }
+            printf(" %lld\n", micros[t][faixa]);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        printf("Uso: GCP_Rastro <arquivo> [--linha-do-tempo [ms] | --resumo]\n");
+        return 1;
+    }
+    size_t n = 0;
+    RegistroRastro *registros = lerRastro(argv[1], &n);
+    if (!registros) return 1;
+
+    if (argc > 2 && strcmp(argv[2], "--resumo") == 0) {
+        resumo(registros, n);
+    } else if (argc <= 2 || strcmp(argv[2], "--linha-do-tempo") == 0) {
+        long janela = argc > 3 ? atol(argv[3]) : 100;
+        linhaDoTempo(registros, n, janela > 0 ? (uint64_t)janela : 100);
+    } else {
+        printf("Opção inválida: %s\n", argv[2]);
+        free(registros);
+        return 1;
+    }
+    free(registros);
+    return 0;
+}
@@ -2,6 +2,13 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // Estrutura que representa uma fórmula CNF (Conjunctive Normal Form)
 typedef struct 
@@ -9,6 +16,7 @@ typedef struct
     int **clausulas;       // Matriz de cláusulas (cada linha é uma cláusula terminada com 0)
     int num_clausulas;     // Número total de cláusulas na fórmula
     int num_literais;      // Número total de variáveis (literais) na fórmula
+    int *arena;            // Bloco único com todos os literais (as cláusulas apontam para dentro dele)
 } Formula;
 
 // Estrutura para representar uma árvore binária de decisão
@@ -36,83 +44,846 @@ bool literal_valido(int literal, int num_literais)
     return (var >= 1 && var <= num_literais);
 }
 
-// Função para ler uma fórmula CNF de um arquivo no formato DIMACS
-Formula* ler_formula(const char *file) 
+// Conteúdo de um arquivo carregado na memória (mapeado com mmap ou, se não der, lido com read)
+typedef struct
 {
-    FILE *arquivo = fopen(file, "r");  // Abre o arquivo para leitura
-    if (!arquivo) 
+    char *dados;      // Bytes do arquivo
+    size_t tamanho;   // Quantidade de bytes
+    bool mapeado;     // true se veio de mmap (liberar com munmap), false se veio de malloc
+} ArquivoCarregado;
+
+// Carrega o arquivo inteiro: tenta mmap e cai para leitura comum em pipes e afins
+static bool carregar_arquivo(int fd, ArquivoCarregado *a)
+{
+    a->dados = NULL;
+    a->tamanho = 0;
+    a->mapeado = false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);  // Leitura é sempre do início ao fim
+            a->dados = p;
+            a->tamanho = (size_t)st.st_size;
+            a->mapeado = true;
+            return true;
+        }
+    }
+
+    // Sem mmap: lê tudo para um buffer que cresce conforme necessário
+    size_t capacidade = 1 << 20;
+    a->dados = malloc(capacidade);
+    while (a->dados)
+    {
+        if (a->tamanho == capacidade)
+        {
+            char *novo = realloc(a->dados, capacidade * 2);
+            if (!novo) { free(a->dados); a->dados = NULL; break; }
+            a->dados = novo;
+            capacidade *= 2;
+        }
+        ssize_t lidos = read(fd, a->dados + a->tamanho, capacidade - a->tamanho);
+        if (lidos < 0) { free(a->dados); a->dados = NULL; break; }
+        if (lidos == 0) break;
+        a->tamanho += (size_t)lidos;
+    }
+    return a->dados != NULL;
+}
+
+static void descarregar_arquivo(ArquivoCarregado *a)
+{
+    if (a->mapeado) munmap(a->dados, a->tamanho);
+    else free(a->dados);
+}
+
+// Leitor de literais DIMACS. Guarda o estado entre uma chamada e outra, então o texto pode
+// chegar em blocos de qualquer tamanho (um número ou comentário pode ficar cortado entre dois
+// blocos). Só o 0 encerra uma cláusula, então cláusulas podem ocupar várias linhas.
+typedef struct
+{
+    int num_literais;             // Maior variável permitida (-1 enquanto o cabeçalho não foi lido)
+    int num_clausulas_cabecalho;  // Quantidade de cláusulas anunciada no cabeçalho
+    int *literais;                // Literais lidos, incluindo os 0 que fecham cláusulas
+    size_t tamanho;               // Quantos literais foram lidos
+    size_t capacidade;            // Espaço alocado em literais
+
+    // Estado que sobrevive entre blocos
+    bool inicio_linha;            // O próximo caractere é o primeiro da linha
+    bool em_comentario;           // Dentro de uma linha 'c'
+    bool em_cabecalho;            // Dentro da linha 'p cnf ...'
+    bool em_numero;               // Lendo um número
+    bool negativo;                // O número atual tem sinal '-'
+    bool tem_digito;              // O número atual já tem pelo menos um dígito
+    long long valor;              // Valor acumulado do número atual
+    char cabecalho[256];          // Texto da linha 'p' (lido em fluxo)
+    int tam_cabecalho;
+
+    // Resultado
+    bool achou_fim;               // Encontrou a marca '%' (fim dos dados em alguns arquivos SATLIB)
+    bool erro_memoria;            // Faltou memória
+    bool erro_sintaxe;            // Caractere inesperado
+    bool erro_cabecalho;          // Cabeçalho ausente, repetido ou mal formado
+    char caractere_erro;          // Caractere que causou o erro de sintaxe
+    long long valor_erro;         // Literal inválido encontrado (0 se nenhum)
+} LeitorLiterais;
+
+static void iniciar_leitor(LeitorLiterais *t, int num_literais, size_t capacidade_inicial)
+{
+    memset(t, 0, sizeof(*t));
+    t->num_literais = num_literais;
+    t->inicio_linha = true;
+    t->capacidade = capacidade_inicial > 16 ? capacidade_inicial : 16;
+    t->literais = malloc(t->capacidade * sizeof(int));
+    if (!t->literais) t->erro_memoria = true;
+}
+
+static bool leitor_ok(const LeitorLiterais *t)
+{
+    return !t->achou_fim && !t->erro_memoria && !t->erro_sintaxe && !t->erro_cabecalho && t->valor_erro == 0;
+}
+
+// Guarda um literal já lido, conferindo se está no intervalo do cabeçalho (false em erro)
+static bool empilhar_literal(LeitorLiterais *t, long long valor)
+{
+    if (t->num_literais < 0)  // Literal antes do cabeçalho
+    {
+        t->erro_cabecalho = true;
+        return false;
+    }
+    if (valor != 0 && (valor > INT_MAX || valor < -INT_MAX || !literal_valido((int)valor, t->num_literais)))
+    {
+        t->valor_erro = valor;
+        return false;
+    }
+    if (t->tamanho == t->capacidade)
+    {
+        size_t nova = t->capacidade * 2;
+        int *novo = realloc(t->literais, nova * sizeof(int));
+        if (!novo) { t->erro_memoria = true; return false; }
+        t->literais = novo;
+        t->capacidade = nova;
+    }
+    t->literais[t->tamanho++] = (int)valor;
+    return true;
+}
+
+// Interpreta a linha 'p cnf V C' acumulada em t->cabecalho
+static void fechar_cabecalho(LeitorLiterais *t)
+{
+    t->em_cabecalho = false;
+    t->cabecalho[t->tam_cabecalho] = '\0';
+    if (t->num_literais >= 0 ||
+        sscanf(t->cabecalho, "p cnf %d %d", &t->num_literais, &t->num_clausulas_cabecalho) != 2 ||
+        t->num_literais < 0 || t->num_clausulas_cabecalho < 0)
+    {
+        t->erro_cabecalho = true;
+    }
+}
+
+// Lê os literais do bloco [p, fim) com um leitor de inteiros feito à mão (sem strtok/atoi).
+// O estado fica em variáveis locais durante o laço e só volta para o leitor na saída.
+static void escanear(LeitorLiterais *t, const char *p, const char *fim)
+{
+    if (!leitor_ok(t)) return;
+
+    bool inicio_linha = t->inicio_linha;
+    bool em_numero = t->em_numero;
+    bool negativo = t->negativo;
+    bool tem_digito = t->tem_digito;
+    long long valor = t->valor;
+
+    while (p < fim)
+    {
+        if (em_numero)
+        {
+            // Laço apertado para os dígitos: é aqui que passa quase todo o arquivo
+            const char *q = p;
+            while (q < fim && (unsigned)(*q - '0') <= 9)
+            {
+                if (valor <= INT_MAX) valor = valor * 10 + (*q - '0');  // Acima disso já é inválido
+                q++;
+            }
+            if (q > p) tem_digito = true;
+            p = q;
+            if (p == fim) break;  // O número continua no próximo bloco
+
+            char ch = *p;
+            if (!tem_digito || (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n'))
+            {
+                t->erro_sintaxe = true;
+                t->caractere_erro = tem_digito ? ch : '-';  // Sem dígito: um '-' solto
+                break;
+            }
+            em_numero = false;
+            if (!empilhar_literal(t, negativo ? -valor : valor)) break;
+            continue;  // O separador é tratado abaixo na próxima volta
+        }
+
+        if (t->em_comentario)  // Pula até o fim da linha
+        {
+            const char *nl = memchr(p, '\n', (size_t)(fim - p));
+            if (!nl) break;
+            t->em_comentario = false;
+            p = nl;
+            continue;
+        }
+
+        if (t->em_cabecalho)  // Acumula a linha 'p' até o '\n'
+        {
+            while (p < fim && *p != '\n')
+            {
+                if (t->tam_cabecalho < (int)sizeof(t->cabecalho) - 1) t->cabecalho[t->tam_cabecalho++] = *p;
+                p++;
+            }
+            if (p == fim) break;
+            fechar_cabecalho(t);
+            if (t->erro_cabecalho) break;
+            continue;
+        }
+
+        char ch = *p;
+        if (ch == '\n') { inicio_linha = true; p++; continue; }
+        if (ch == ' ' || ch == '\t' || ch == '\r') { p++; continue; }
+
+        if (inicio_linha && ch == 'c') { t->em_comentario = true; continue; }
+        if (inicio_linha && ch == 'p') { t->em_cabecalho = true; t->tam_cabecalho = 0; continue; }
+        if (ch == '%') { t->achou_fim = true; break; }
+        inicio_linha = false;
+
+        if (ch == '-' || (ch >= '0' && ch <= '9'))
+        {
+            em_numero = true;
+            negativo = ch == '-';
+            tem_digito = false;
+            valor = 0;
+            if (ch == '-') p++;
+            continue;
+        }
+
+        t->erro_sintaxe = true;
+        t->caractere_erro = ch;
+        break;
+    }
+
+    t->inicio_linha = inicio_linha;
+    t->em_numero = em_numero;
+    t->negativo = negativo;
+    t->tem_digito = tem_digito;
+    t->valor = valor;
+}
+
+// Termina a leitura: fecha um número ou cabeçalho que acabou junto com o arquivo
+static void finalizar_leitor(LeitorLiterais *t)
+{
+    if (!leitor_ok(t)) return;
+    if (t->em_numero)
+    {
+        t->em_numero = false;
+        if (!t->tem_digito) { t->erro_sintaxe = true; t->caractere_erro = '-'; return; }
+        empilhar_literal(t, t->negativo ? -t->valor : t->valor);
+    }
+    if (t->em_cabecalho) fechar_cabecalho(t);
+}
+
+// Mostra o erro de um leitor (se houver) e devolve true quando a leitura falhou
+static bool reportar_erro_leitura(const LeitorLiterais *t)
+{
+    if (t->erro_memoria)
+    {
+        printf("Erro: memoria insuficiente para ler a formula\n");
+        return true;
+    }
+    if (t->erro_cabecalho)
+    {
+        printf("Erro: cabecalho 'p cnf' ausente ou invalido\n");
+        return true;
+    }
+    if (t->valor_erro != 0)
+    {
+        printf("Erro: literal %lld invalido (max: %d)\n", t->valor_erro, t->num_literais);
+        printf("UNSAT\n");
+        return true;
+    }
+    if (t->erro_sintaxe)
+    {
+        printf("Erro: caractere inesperado '%c' na formula\n", t->caractere_erro);
+        return true;
+    }
+    return false;
+}
+
+// Junta os literais de um ou mais leitores (na ordem) em uma fórmula com arena única
+static Formula *montar_formula(LeitorLiterais *partes, int num_partes, int num_vars, int num_clausulas_cabecalho)
+{
+    size_t total = 0;
+    for (int i = 0; i < num_partes; i++)
+    {
+        if (reportar_erro_leitura(&partes[i])) return NULL;
+        total += partes[i].tamanho;
+        if (partes[i].achou_fim) { num_partes = i + 1; break; }  // Nada depois do '%' conta
+    }
+
+    Formula *f = malloc(sizeof(Formula));
+    if (f) f->arena = malloc((total + 1) * sizeof(int));
+    if (!f || !f->arena)
+    {
+        free(f);
+        printf("Erro: memoria insuficiente para ler a formula\n");
+        return NULL;
+    }
+
+    // Junta os trechos na arena e aponta cada cláusula para o seu começo
+    size_t pos = 0;
+    for (int i = 0; i < num_partes; i++)
+    {
+        memcpy(f->arena + pos, partes[i].literais, partes[i].tamanho * sizeof(int));
+        pos += partes[i].tamanho;
+    }
+    if (pos > 0 && f->arena[pos - 1] != 0) f->arena[pos++] = 0;  // Última cláusula sem o 0 final
+
+    long long num_clausulas = 0;
+    for (size_t i = 0; i < pos; i++) if (f->arena[i] == 0) num_clausulas++;
+
+    f->num_literais = num_vars;
+    f->num_clausulas = (int)num_clausulas;
+    f->clausulas = num_clausulas > INT_MAX ? NULL : malloc((num_clausulas > 0 ? num_clausulas : 1) * sizeof(int*));
+    if (!f->clausulas)
+    {
+        printf("Erro: memoria insuficiente para ler a formula\n");
+        free(f->arena);
+        free(f);
+        return NULL;
+    }
+
+    int c = 0;
+    size_t ini_clausula = 0;
+    for (size_t i = 0; i < pos; i++)
+    {
+        if (f->arena[i] == 0)
+        {
+            f->clausulas[c++] = f->arena + ini_clausula;
+            ini_clausula = i + 1;
+        }
+    }
+
+    if (f->num_clausulas != num_clausulas_cabecalho)
+    {
+        fprintf(stderr, "Aviso: cabecalho anuncia %d clausulas, mas foram lidas %d\n",
+                num_clausulas_cabecalho, f->num_clausulas);
+    }
+    return f;
+}
+
+// Trecho do arquivo mapeado lido por uma thread. Os trechos sempre começam no início de uma
+// linha, então nenhum número é cortado ao meio; uma cláusula pode atravessar trechos sem
+// problema, pois a sequência de literais (com os 0) é simplesmente concatenada no final.
+typedef struct
+{
+    const char *ini;        // Primeiro byte do trecho
+    const char *fim;        // Um byte depois do último
+    LeitorLiterais *leitor; // Onde os literais do trecho são guardados
+} TrechoLeitura;
+
+static void *ler_trecho(void *arg)
+{
+    TrechoLeitura *t = arg;
+    escanear(t->leitor, t->ini, t->fim);
+    finalizar_leitor(t->leitor);
+    return NULL;
+}
+
+// Lê o cabeçalho "p cnf V C" pulando comentários; devolve o ponteiro para a linha seguinte
+static const char *ler_cabecalho(const char *p, const char *fim, int *num_vars, int *num_clausulas)
+{
+    while (p < fim)
+    {
+        const char *nl = memchr(p, '\n', (size_t)(fim - p));
+        const char *prox = nl ? nl + 1 : fim;
+
+        const char *q = p;
+        while (q < prox && (*q == ' ' || *q == '\t' || *q == '\r' || *q == '\n')) q++;
+
+        if (q < prox && *q == 'p')
+        {
+            char linha[256];
+            size_t n = (size_t)(prox - q) < sizeof(linha) - 1 ? (size_t)(prox - q) : sizeof(linha) - 1;
+            memcpy(linha, q, n);
+            linha[n] = '\0';
+            if (sscanf(linha, "p cnf %d %d", num_vars, num_clausulas) != 2) return NULL;
+            return prox;
+        }
+        if (q < prox && *q != 'c') return NULL;  // Dados antes do cabeçalho
+        p = prox;
+    }
+    return NULL;
+}
+
+static double segundos_agora(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Leitura de arquivo texto: mapeia o arquivo e, com num_threads > 1, divide em trechos lidos em paralelo.
+// Em *threads_usadas fica quantas threads leram de fato (corpos pequenos usam menos que o pedido).
+static Formula *ler_formula_texto(int fd, int num_threads, size_t *bytes_lidos, int *threads_usadas)
+{
+    ArquivoCarregado a;
+    if (!carregar_arquivo(fd, &a))
     {
         printf("Erro ao abrir o arquivo");
         return NULL;
     }
+    *bytes_lidos = a.tamanho;
 
-    // Aloca memória para a estrutura da fórmula
-    Formula *f = malloc(sizeof(Formula));
-    f->clausulas = NULL;     // Inicializa o ponteiro para cláusulas como NULL
-    f->num_clausulas = 0;    // Inicializa contador de cláusulas
-    f->num_literais = 0;     // Inicializa contador de literais
+    int num_vars = 0, num_clausulas_cabecalho = 0;
+    const char *fim = a.dados + a.tamanho;
+    const char *corpo = ler_cabecalho(a.dados, fim, &num_vars, &num_clausulas_cabecalho);
+    if (!corpo || num_vars < 0 || num_clausulas_cabecalho < 0)
+    {
+        printf("Erro: cabecalho 'p cnf' ausente ou invalido\n");
+        descarregar_arquivo(&a);
+        return NULL;
+    }
 
-    char linha[1000];         // Buffer para ler linhas do arquivo
-    int clausula_atual = 0;  // Índice da cláusula sendo processada
+    // Divide o corpo em trechos que começam sempre logo depois de um '\n'
+    if (num_threads < 1) num_threads = 1;
+    size_t tamanho_corpo = (size_t)(fim - corpo);
+    if (tamanho_corpo < (size_t)num_threads * (1 << 20)) num_threads = tamanho_corpo / (1 << 20) + 1;  // Trechos de pelo menos 1 MB
+    *threads_usadas = num_threads;
 
-    // Lê o arquivo linha por linha
-    while (fgets(linha, sizeof(linha), arquivo)) 
+    TrechoLeitura *trechos = calloc(num_threads, sizeof(TrechoLeitura));
+    LeitorLiterais *leitores = calloc(num_threads, sizeof(LeitorLiterais));
+    pthread_t *threads = calloc(num_threads, sizeof(pthread_t));
+    if (!trechos || !leitores || !threads)
     {
-        if (linha[0] == 'c') continue;  // Ignora linhas de comentário (começam com 'c')
-        
-        // Linha de parâmetro (começa com 'p')
-        if (linha[0] == 'p') 
+        free(trechos);
+        free(leitores);
+        free(threads);
+        descarregar_arquivo(&a);
+        printf("Erro ao alocar leitura\n");
+        return NULL;
+    }
+
+    const char *p = corpo;
+    for (int i = 0; i < num_threads; i++)
+    {
+        const char *limite = (i == num_threads - 1) ? fim : corpo + tamanho_corpo / num_threads * (i + 1);
+        if (limite < p) limite = p;
+        if (limite < fim)
         {
-            // Extrai o número de literais e cláusulas da linha
-            sscanf(linha, "p cnf %d %d", &f->num_literais, &f->num_clausulas);
-            // Aloca memória para o vetor de ponteiros para cláusulas
-            f->clausulas = malloc(f->num_clausulas * sizeof(int*));
-            continue;
+            const char *nl = memchr(limite, '\n', (size_t)(fim - limite));
+            limite = nl ? nl + 1 : fim;
         }
+        trechos[i].ini = p;
+        trechos[i].fim = limite;
+        trechos[i].leitor = &leitores[i];
+        iniciar_leitor(&leitores[i], num_vars, (size_t)(limite - p) / 4);  // Estimativa: um literal a cada ~4 bytes
+        p = limite;
+    }
 
-        // Processa uma cláusula
-        int *clausula = malloc((f->num_literais + 1) * sizeof(int));  // Aloca espaço para os literais + terminador 0
-        int literal, tamanho = 0;
-        
-        // Divide a linha em tokens usando espaços, tabs e quebras de linha como delimitadores
-        char *token = strtok(linha, " \t\n");
-        
-        // Processa cada token (literal) da cláusula
-        while (token != NULL) 
+    if (num_threads == 1)
+    {
+        ler_trecho(&trechos[0]);
+    }
+    else
+    {
+        for (int i = 0; i < num_threads; i++) pthread_create(&threads[i], NULL, ler_trecho, &trechos[i]);
+        for (int i = 0; i < num_threads; i++) pthread_join(threads[i], NULL);
+    }
+
+    Formula *f = montar_formula(leitores, num_threads, num_vars, num_clausulas_cabecalho);
+
+    for (int i = 0; i < num_threads; i++) free(leitores[i].literais);
+    free(leitores);
+    free(trechos);
+    free(threads);
+    descarregar_arquivo(&a);
+    return f;
+}
+
+// === Entrada comprimida ===
+// Suporte a cada formato é ligado na compilação, com a biblioteca do sistema:
+//   gzip: -DCOM_ZLIB -lz    xz: -DCOM_LZMA -llzma    zstd: -DCOM_ZSTD -lzstd
+#ifdef COM_ZLIB
+#include <zlib.h>
+#endif
+#ifdef COM_LZMA
+#include <lzma.h>
+#endif
+#ifdef COM_ZSTD
+#include <zstd.h>
+#endif
+
+typedef enum { FORMATO_TEXTO, FORMATO_GZIP, FORMATO_XZ, FORMATO_ZSTD } FormatoArquivo;
+
+static const char *nome_formato[] = { "texto", "gzip", "xz", "zstd" };
+
+// Reconhece o formato pelos primeiros bytes do arquivo (números mágicos)
+static FormatoArquivo detectar_formato(int fd)
+{
+    unsigned char m[6];
+    ssize_t n = pread(fd, m, sizeof(m), 0);  // Não mexe na posição de leitura
+    if (n >= 2 && m[0] == 0x1f && m[1] == 0x8b) return FORMATO_GZIP;
+    if (n >= 6 && memcmp(m, "\xfd" "7zXZ\0", 6) == 0) return FORMATO_XZ;
+    if (n >= 4 && m[0] == 0x28 && m[1] == 0xb5 && m[2] == 0x2f && m[3] == 0xfd) return FORMATO_ZSTD;
+    return FORMATO_TEXTO;
+}
+
+#define TAM_ENTRADA_COMPRIMIDA (1 << 16)   // Bytes comprimidos lidos do disco por vez
+#define TAM_BLOCO_DESCOMPRIMIDO (1 << 20)  // Bytes descomprimidos entregues ao leitor por vez
+#define NUM_BLOCOS_FILA 4                  // Blocos em trânsito entre as duas threads
+
+// Descompressor em fluxo de um dos formatos suportados
+typedef struct
+{
+    FormatoArquivo formato;
+    int fd;
+    unsigned char entrada[TAM_ENTRADA_COMPRIMIDA];
+    bool fim_entrada;
+    bool fim_saida;
+    bool truncado;            // O arquivo acabou no meio do fluxo comprimido
+#ifdef COM_ZLIB
+    gzFile gz;
+#endif
+#ifdef COM_LZMA
+    lzma_stream xz;
+#endif
+#ifdef COM_ZSTD
+    ZSTD_DStream *zstd;
+    ZSTD_inBuffer zstd_entrada;
+    size_t zstd_pendente;     // Retorno do último ZSTD_decompressStream (0 = quadro completo)
+#endif
+} Descompressor;
+
+static bool abrir_descompressor(Descompressor *d, int fd, FormatoArquivo formato)
+{
+    d->formato = formato;
+    d->fd = fd;
+    d->fim_entrada = false;
+    d->fim_saida = false;
+    d->truncado = false;
+
+    switch (formato)
+    {
+#ifdef COM_ZLIB
+    case FORMATO_GZIP:
+        d->gz = gzdopen(dup(fd), "rb");
+        if (!d->gz) return false;
+        gzbuffer(d->gz, TAM_ENTRADA_COMPRIMIDA);
+        return true;
+#endif
+#ifdef COM_LZMA
+    case FORMATO_XZ:
+    {
+        lzma_stream inicial = LZMA_STREAM_INIT;
+        d->xz = inicial;
+        return lzma_stream_decoder(&d->xz, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK;
+    }
+#endif
+#ifdef COM_ZSTD
+    case FORMATO_ZSTD:
+        d->zstd = ZSTD_createDStream();
+        d->zstd_entrada.src = d->entrada;
+        d->zstd_entrada.size = 0;
+        d->zstd_entrada.pos = 0;
+        d->zstd_pendente = 1;  // Nenhum quadro lido ainda
+        return d->zstd && !ZSTD_isError(ZSTD_initDStream(d->zstd));
+#endif
+    default:
+        printf("Erro: arquivo em formato %s, mas o programa foi compilado sem suporte a ele\n", nome_formato[formato]);
+        return false;
+    }
+}
+
+static void fechar_descompressor(Descompressor *d)
+{
+    switch (d->formato)
+    {
+#ifdef COM_ZLIB
+    case FORMATO_GZIP: gzclose(d->gz); break;
+#endif
+#ifdef COM_LZMA
+    case FORMATO_XZ: lzma_end(&d->xz); break;
+#endif
+#ifdef COM_ZSTD
+    case FORMATO_ZSTD: ZSTD_freeDStream(d->zstd); break;
+#endif
+    default: break;
+    }
+}
+
+// Preenche até cap bytes descomprimidos em buf; devolve quantos (0 no fim) ou -1 em erro
+// (com d->truncado ligado quando o erro é o arquivo acabar antes do fim do fluxo)
+static ssize_t descomprimir(Descompressor *d, char *buf, size_t cap)
+{
+    if (d->fim_saida) return 0;
+
+    switch (d->formato)
+    {
+#ifdef COM_ZLIB
+    case FORMATO_GZIP:
+    {
+        int n = gzread(d->gz, buf, (unsigned)cap);
+        if (n <= 0)
         {
-            literal = atoi(token);  // Converte o token para inteiro
-            if (literal == 0) break;  // Se for 0, indica fim da cláusula
-            if (!literal_valido(literal, f->num_literais))
+            // O gzread devolve 0 também quando o arquivo acaba no meio do fluxo: o gzerror diz qual foi
+            int erro;
+            gzerror(d->gz, &erro);
+            if (erro == Z_BUF_ERROR)
             {
-                printf("Erro: literal %d invalido (max: %d)\n", literal, f->num_literais);
-                printf("UNSAT\n");
-                free(clausula);
-                fclose(arquivo);
-                return NULL;
+                d->truncado = true;
+                return -1;
+            }
+            if (n == 0) d->fim_saida = true;
+        }
+        return n;
+    }
+#endif
+#ifdef COM_LZMA
+    case FORMATO_XZ:
+    {
+        d->xz.next_out = (uint8_t *)buf;
+        d->xz.avail_out = cap;
+        while (d->xz.avail_out > 0)
+        {
+            if (d->xz.avail_in == 0 && !d->fim_entrada)
+            {
+                ssize_t n = read(d->fd, d->entrada, sizeof(d->entrada));
+                if (n < 0) return -1;
+                if (n == 0) d->fim_entrada = true;
+                d->xz.next_in = d->entrada;
+                d->xz.avail_in = (size_t)n;
+            }
+            lzma_ret r = lzma_code(&d->xz, d->fim_entrada ? LZMA_FINISH : LZMA_RUN);
+            if (r == LZMA_STREAM_END) { d->fim_saida = true; break; }
+            if (r == LZMA_BUF_ERROR && d->fim_entrada) d->truncado = true;  // LZMA_FINISH sem o fim do fluxo
+            if (r != LZMA_OK) return -1;
+        }
+        return (ssize_t)(cap - d->xz.avail_out);
+    }
+#endif
+#ifdef COM_ZSTD
+    case FORMATO_ZSTD:
+    {
+        ZSTD_outBuffer saida = { buf, cap, 0 };
+        while (saida.pos < saida.size)
+        {
+            if (d->zstd_entrada.pos == d->zstd_entrada.size && !d->fim_entrada)
+            {
+                ssize_t n = read(d->fd, d->entrada, sizeof(d->entrada));
+                if (n < 0) return -1;
+                if (n == 0) d->fim_entrada = true;
+                d->zstd_entrada.size = (size_t)n;
+                d->zstd_entrada.pos = 0;
+            }
+            bool sem_entrada = d->fim_entrada && d->zstd_entrada.pos == d->zstd_entrada.size;
+            if (sem_entrada && d->zstd_pendente == 0) { d->fim_saida = true; break; }  // Último quadro completo
 
+            // Sem entrada, a chamada ainda esvazia o que o decodificador guardou; se nada sai, o quadro ficou pela metade
+            size_t antes = saida.pos;
+            size_t r = ZSTD_decompressStream(d->zstd, &saida, &d->zstd_entrada);
+            if (ZSTD_isError(r)) return -1;
+            d->zstd_pendente = r;
+            if (sem_entrada && r != 0 && saida.pos == antes)
+            {
+                d->truncado = true;
+                return -1;
             }
-            clausula[tamanho++] = literal;  // Armazena o literal no vetor
-            token = strtok(NULL, " \t\n");  // Pega o próximo token
         }
-        
-        clausula[tamanho] = 0;  // Adiciona o terminador 0 no final da cláusula
-        
-        // Armazena a cláusula na fórmula
-        f->clausulas[clausula_atual++] = clausula;
+        return (ssize_t)saida.pos;
     }
+#endif
+    default:
+        (void)buf;
+        (void)cap;
+        return -1;
+    }
+}
+
+// Fila de blocos descomprimidos: a thread de descompressão enche, a thread principal lê.
+// Assim a leitura do texto acontece ao mesmo tempo que a descompressão do próximo bloco.
+typedef struct
+{
+    Descompressor *d;
+    char *blocos[NUM_BLOCOS_FILA];
+    size_t tamanhos[NUM_BLOCOS_FILA];
+    int inicio;               // Bloco cheio mais antigo
+    int quantidade;           // Blocos cheios esperando leitura (o do início pode estar em uso)
+    bool terminou;            // A descompressão chegou ao fim
+    bool erro;                // A descompressão falhou
+    bool cancelar;            // O leitor desistiu (erro no texto); a descompressão deve parar
+    size_t bytes_descomprimidos;
+    pthread_mutex_t trava;
+    pthread_cond_t tem_bloco;
+    pthread_cond_t tem_espaco;
+} FilaDescompressao;
+
+static void *thread_descompressao(void *arg)
+{
+    FilaDescompressao *q = arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&q->trava);
+        while (q->quantidade == NUM_BLOCOS_FILA && !q->cancelar) pthread_cond_wait(&q->tem_espaco, &q->trava);
+        bool cancelar = q->cancelar;
+        int slot = (q->inicio + q->quantidade) % NUM_BLOCOS_FILA;
+        pthread_mutex_unlock(&q->trava);
+        if (cancelar) return NULL;
+
+        // Enche o bloco inteiro (os descompressores podem devolver menos que o pedido)
+        size_t cheio = 0;
+        ssize_t n = 1;
+        while (cheio < TAM_BLOCO_DESCOMPRIMIDO && n > 0)
+        {
+            n = descomprimir(q->d, q->blocos[slot] + cheio, TAM_BLOCO_DESCOMPRIMIDO - cheio);
+            if (n > 0) cheio += (size_t)n;
+        }
 
-    fclose(arquivo);  // Fecha o arquivo
-    return f;         // Retorna a fórmula lida
+        pthread_mutex_lock(&q->trava);
+        if (cheio > 0)
+        {
+            q->tamanhos[slot] = cheio;
+            q->quantidade++;
+            q->bytes_descomprimidos += cheio;
+        }
+        if (n < 0) q->erro = true;
+        if (n <= 0) q->terminou = true;
+        pthread_cond_signal(&q->tem_bloco);
+        pthread_mutex_unlock(&q->trava);
+        if (n <= 0) return NULL;
+    }
 }
 
-// Função para liberar a memória alocada para a fórmula
-void liberar_formula(Formula *f) 
+// Leitura de arquivo comprimido: descompressão e leitura do texto em paralelo, sem arquivo temporário
+static Formula *ler_formula_comprimida(int fd, FormatoArquivo formato, size_t *bytes_descomprimidos)
 {
-    // Libera cada cláusula individualmente
-    for (int i = 0; i < f->num_clausulas; i++) 
+    Descompressor *d = malloc(sizeof(Descompressor));
+    if (!d || !abrir_descompressor(d, fd, formato))
+    {
+        free(d);
+        return NULL;
+    }
+
+    FilaDescompressao q;
+    memset(&q, 0, sizeof(q));
+    q.d = d;
+    pthread_mutex_init(&q.trava, NULL);
+    pthread_cond_init(&q.tem_bloco, NULL);
+    pthread_cond_init(&q.tem_espaco, NULL);
+    bool ok = true;
+    for (int i = 0; i < NUM_BLOCOS_FILA; i++)
+    {
+        q.blocos[i] = malloc(TAM_BLOCO_DESCOMPRIMIDO);
+        if (!q.blocos[i]) ok = false;
+    }
+
+    LeitorLiterais leitor;
+    iniciar_leitor(&leitor, -1, TAM_BLOCO_DESCOMPRIMIDO / 4);  // O cabeçalho vem no próprio fluxo
+
+    pthread_t produtor;
+    if (ok && pthread_create(&produtor, NULL, thread_descompressao, &q) == 0)
     {
-        free(f->clausulas[i]);
+        for (;;)
+        {
+            pthread_mutex_lock(&q.trava);
+            while (q.quantidade == 0 && !q.terminou) pthread_cond_wait(&q.tem_bloco, &q.trava);
+            if (q.quantidade == 0)  // Terminou e não sobrou bloco
+            {
+                pthread_mutex_unlock(&q.trava);
+                break;
+            }
+            char *bloco = q.blocos[q.inicio];
+            size_t tamanho = q.tamanhos[q.inicio];
+            pthread_mutex_unlock(&q.trava);
+
+            escanear(&leitor, bloco, bloco + tamanho);  // Lê fora da trava: a descompressão segue em paralelo
+
+            pthread_mutex_lock(&q.trava);
+            q.inicio = (q.inicio + 1) % NUM_BLOCOS_FILA;
+            q.quantidade--;
+            if (!leitor_ok(&leitor)) q.cancelar = true;
+            pthread_cond_signal(&q.tem_espaco);
+            pthread_mutex_unlock(&q.trava);
+            if (!leitor_ok(&leitor)) break;
+        }
+        pthread_join(produtor, NULL);
+        finalizar_leitor(&leitor);
+        if (q.erro)
+        {
+            if (d->truncado)
+                printf("Erro: arquivo %s truncado (o fluxo comprimido acaba antes do fim)\n", nome_formato[formato]);
+            else
+                printf("Erro: arquivo %s corrompido\n", nome_formato[formato]);
+            ok = false;
+        }
+        else if (leitor.num_literais < 0 && leitor_ok(&leitor))
+        {
+            leitor.erro_cabecalho = true;  // Arquivo sem linha 'p'
+        }
+    }
+    else
+    {
+        printf("Erro ao iniciar a descompressao\n");
+        ok = false;
+    }
+
+    Formula *f = ok ? montar_formula(&leitor, 1, leitor.num_literais, leitor.num_clausulas_cabecalho) : NULL;
+    *bytes_descomprimidos = q.bytes_descomprimidos;
+
+    free(leitor.literais);
+    for (int i = 0; i < NUM_BLOCOS_FILA; i++) free(q.blocos[i]);
+    pthread_mutex_destroy(&q.trava);
+    pthread_cond_destroy(&q.tem_bloco);
+    pthread_cond_destroy(&q.tem_espaco);
+    fechar_descompressor(d);
+    free(d);
+    return f;
+}
+
+// Função para ler uma fórmula CNF de um arquivo no formato DIMACS, em texto ou comprimido
+// (gzip, xz ou zstd, reconhecidos pelos primeiros bytes do arquivo).
+// Cláusulas podem ocupar várias linhas (só o 0 encerra uma cláusula) e não há limite de tamanho de linha.
+Formula* ler_formula(const char *file, int num_threads) 
+{
+    double inicio = segundos_agora();
+
+    int fd = open(file, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("Erro ao abrir o arquivo");
+        return NULL;
+    }
+
+    FormatoArquivo formato = detectar_formato(fd);
+    size_t bytes = 0;
+    int threads_usadas = 1;
+    Formula *f = formato == FORMATO_TEXTO ? ler_formula_texto(fd, num_threads, &bytes, &threads_usadas)
+                                          : ler_formula_comprimida(fd, formato, &bytes);
+    close(fd);
+
+    if (f)
+    {
+        double segundos = segundos_agora() - inicio;
+        double mb = bytes / 1e6;
+        if (formato == FORMATO_TEXTO)
+            fprintf(stderr, "Leitura: %.1f MB em %.3f s (%.1f MB/s, %d thread%s)\n",
+                    mb, segundos, segundos > 0 ? mb / segundos : 0.0, threads_usadas, threads_usadas > 1 ? "s" : "");
+        else
+            fprintf(stderr, "Leitura: %.1f MB descomprimidos (%s) em %.3f s (%.1f MB/s)\n",
+                    mb, nome_formato[formato], segundos, segundos > 0 ? mb / segundos : 0.0);
     }
+    return f;
+}
+
+// Função para liberar a memória alocada para a fórmula
+void liberar_formula(Formula *f) 
+{
+    free(f->arena);      // Libera de uma vez todos os literais
     free(f->clausulas);  // Libera o vetor de cláusulas
     free(f);             // Libera a estrutura da fórmula
 }
@@ -269,10 +1040,12 @@ bool SAT(Formula *f, int *interpretacao, BinaryTree *no)
 }
  
 // Função principal
-int main() 
+// Uso: SAT_Solver [arquivo.cnf | arquivo.cnf.gz | .xz | .zst] [threads de leitura]
+int main(int argc, char *argv[]) 
 {
-    const char *arquivo = "SAT.cnf";  // Arquivo de entrada no formato DIMACS
-    Formula *f = ler_formula(arquivo);  // Lê a fórmula do arquivo
+    const char *arquivo = argc > 1 ? argv[1] : "SAT.cnf";  // Arquivo de entrada no formato DIMACS
+    int threads_leitura = argc > 2 ? atoi(argv[2]) : 1;    // Threads usadas para ler a fórmula
+    Formula *f = ler_formula(arquivo, threads_leitura);    // Lê a fórmula do arquivo
     
     if (!f) // Equivalente a: if (f == NULL)
     {